@@ -0,0 +1,617 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include "FTAtlas.h"
+#include "FTFont/FTTextureFontImpl.h"
+
+
+static inline GLuint NextPowerOf2(GLuint in)
+{
+     in -= 1;
+
+     in |= in >> 16;
+     in |= in >> 8;
+     in |= in >> 4;
+     in |= in >> 2;
+     in |= in >> 1;
+
+     return in + 1;
+}
+
+
+FTAtlas::FTAtlas()
+:   refs(1),
+    currentPage(0),
+    freeEntry(-1),
+    entryCount(0),
+    freeOwner(-1),
+    pageSize(0),
+    pageBudget(0),
+    maximumTextureSize(0),
+    renderCount(0),
+    written(false)
+{
+    Rehash(256);
+}
+
+
+FTAtlas::~FTAtlas()
+{
+    DeletePages();
+}
+
+
+void FTAtlas::Retain()
+{
+    ++refs;
+}
+
+
+void FTAtlas::Release()
+{
+    if(--refs == 0)
+    {
+        delete this;
+    }
+}
+
+
+unsigned int FTAtlas::Hash(const FTAtlasKey& key)
+{
+    unsigned int h = 2166136261u;
+
+    h = (h ^ static_cast<unsigned int>(key.face)) * 16777619u;
+    h = (h ^ static_cast<unsigned int>(key.xScale)) * 16777619u;
+    h = (h ^ static_cast<unsigned int>(key.yScale)) * 16777619u;
+    h = (h ^ key.glyph) * 16777619u;
+    h = (h ^ key.variant) * 16777619u;
+
+    return h;
+}
+
+
+int FTAtlas::Find(const FTAtlasKey& key) const
+{
+    int e = buckets[Hash(key) & (buckets.size() - 1)];
+
+    while(e >= 0)
+    {
+        const FTAtlasKey& k = entries[e].key;
+
+        if(k.glyph == key.glyph && k.face == key.face
+           && k.xScale == key.xScale && k.yScale == key.yScale
+           && k.variant == key.variant)
+        {
+            return e;
+        }
+        e = entries[e].next;
+    }
+
+    return -1;
+}
+
+
+int FTAtlas::Place(const FTAtlasKey& key, int width, int height,
+                   int pageWidth, int pageHeight, int& x, int& y,
+                   bool& found)
+{
+    int e = Find(key);
+
+    if(e >= 0)
+    {
+        found = true;
+        x = entries[e].x;
+        y = entries[e].y;
+        return e;
+    }
+
+    found = false;
+
+    if(pages.empty())
+    {
+        AddPage(pageWidth, pageHeight);
+    }
+
+    if(!packer.Insert(width, height, x, y))
+    {
+        // A glyph larger than a page gets a page large enough for it
+        AddPage(pageWidth, pageHeight, width, height);
+
+        // Larger than the largest texture: draw what fits, and leave the
+        // page to it alone so nothing is packed over it
+        if(!packer.Insert(width, height, x, y))
+        {
+            x = y = 0;
+            packer.Reset(0, 0);
+        }
+    }
+
+    pages[currentPage]->glyphArea += static_cast<long>(width) * height;
+
+    return AddEntry(key, currentPage, x, y);
+}
+
+
+int FTAtlas::AddEntry(const FTAtlasKey& key, int page, int x, int y)
+{
+    int e;
+    Entry entry;
+    entry.key = key;
+    entry.page = page;
+    entry.x = x;
+    entry.y = y;
+
+    if(freeEntry >= 0)
+    {
+        e = freeEntry;
+        freeEntry = entries[e].next;
+        entries[e] = entry;
+    }
+    else
+    {
+        e = entries.size();
+        entries.push_back(entry);
+    }
+
+    unsigned int bucket = Hash(key) & (buckets.size() - 1);
+    entries[e].next = buckets[bucket];
+    buckets[bucket] = e;
+
+    if(++entryCount > buckets.size())
+    {
+        Rehash(buckets.size() * 2);
+    }
+
+    return e;
+}
+
+
+int FTAtlas::AdoptPage(int width, int height, const unsigned char* pixels)
+{
+    Page *page = new Page;
+    page->texture = ftglesCreateTexture();
+    page->width = width;
+    page->height = height;
+    page->glyphArea = 0;
+    page->lastUsed = renderCount;
+    page->pixels = new unsigned char[width * height];
+    page->dirtyTop = page->dirtyBottom = 0;
+    page->owners = -1;
+
+    memcpy(page->pixels, pixels, width * height);
+    ftglesTextureImage(page->texture, width, height, page->pixels);
+
+    // The packer stays on the current page; with none, the next glyph
+    // starts a new one rather than guessing where this one has room.
+    pages.push_back(page);
+    if(pages.size() == 1)
+    {
+        packer.Reset(0, 0);
+    }
+
+    return pages.size() - 1;
+}
+
+
+int FTAtlas::Adopt(const FTAtlasKey& key, int& page, int& x, int& y,
+                   int width, int height)
+{
+    int e = Find(key);
+
+    if(e >= 0)
+    {
+        page = entries[e].page;
+        x = entries[e].x;
+        y = entries[e].y;
+        return e;
+    }
+
+    pages[page]->glyphArea += static_cast<long>(width) * height;
+
+    return AddEntry(key, page, x, y);
+}
+
+
+int FTAtlas::PageIndex(GLuint texture) const
+{
+    for(unsigned int i = 0; i < pages.size(); ++i)
+    {
+        if(pages[i]->texture == texture)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+int FTAtlas::AddOwner(int entry, FTTextureFontImpl* font, FTGlyph* glyph,
+                      unsigned int charCode, int first)
+{
+    // Glyphs without a bitmap have nothing to lose
+    if(entry < 0)
+    {
+        return first;
+    }
+
+    int o;
+    if(freeOwner >= 0)
+    {
+        o = freeOwner;
+        freeOwner = owners[o].next;
+    }
+    else
+    {
+        o = owners.size();
+        owners.push_back(Owner());
+    }
+
+    Owner& owner = owners[o];
+    Page *page = pages[entries[entry].page];
+
+    owner.font = font;
+    owner.glyph = glyph;
+    owner.charCode = charCode;
+    owner.entry = entry;
+    owner.page = entries[entry].page;
+    owner.prev = -1;
+    owner.next = page->owners;
+    if(page->owners >= 0)
+    {
+        owners[page->owners].prev = o;
+    }
+    page->owners = o;
+
+    if(first < 0)
+    {
+        owner.sibling = o;
+        return o;
+    }
+
+    owner.sibling = owners[first].sibling;
+    owners[first].sibling = o;
+    return first;
+}
+
+
+void FTAtlas::ReleaseFont(FTTextureFontImpl* font, bool unload)
+{
+    for(unsigned int i = 0; i < owners.size(); ++i)
+    {
+        if(owners[i].font != font)
+        {
+            continue;
+        }
+
+        // Drops the glyph's other records too, so it is unloaded once
+        Owner owner = owners[i];
+        RemoveOwners(i);
+
+        if(unload)
+        {
+            font->Evicted(owner.glyph, owner.charCode);
+        }
+    }
+}
+
+
+void FTAtlas::ReleaseScale(FTTextureFontImpl* font, long xScale,
+                           long yScale)
+{
+    for(unsigned int i = 0; i < owners.size(); ++i)
+    {
+        if(owners[i].font != font)
+        {
+            continue;
+        }
+
+        const FTAtlasKey& key = entries[owners[i].entry].key;
+
+        if(key.xScale == xScale && key.yScale == yScale)
+        {
+            RemoveOwners(i);
+        }
+    }
+}
+
+
+void FTAtlas::Write(int entry, int x, int y, const unsigned char* pixels,
+                    int width, int rows, int pitch)
+{
+    Page *page = pages[entries[entry].page];
+    int height = rows;
+
+    // A glyph larger than the page is cut down to what fits
+    width = x + width > page->width ? page->width - x : width;
+    rows = y + rows > page->height ? page->height - y : rows;
+
+    if(width <= 0 || rows <= 0)
+    {
+        return;
+    }
+
+    for(int r = 0; r < rows; ++r)
+    {
+        const unsigned char *src = pitch >= 0
+            ? pixels + r * pitch
+            : pixels + (height - 1 - r) * -pitch;
+
+        memcpy(page->pixels + (y + r) * page->width + x, src, width);
+    }
+
+    if(page->dirtyTop >= page->dirtyBottom)
+    {
+        page->dirtyTop = y;
+        page->dirtyBottom = y + rows;
+    }
+    else
+    {
+        page->dirtyTop = y < page->dirtyTop ? y : page->dirtyTop;
+        page->dirtyBottom = y + rows > page->dirtyBottom
+                          ? y + rows : page->dirtyBottom;
+    }
+
+    written = true;
+}
+
+
+void FTAtlas::Upload()
+{
+    if(!written)
+    {
+        return;
+    }
+
+    written = false;
+
+    for(unsigned int i = 0; i < pages.size(); ++i)
+    {
+        Page *page = pages[i];
+
+        if(page->dirtyTop >= page->dirtyBottom)
+        {
+            continue;
+        }
+
+        // Whole rows, as GLES 1 cannot upload part of a wider image
+        ftglesTextureSubImage(page->texture, 0, page->dirtyTop, page->width,
+                              page->dirtyBottom - page->dirtyTop,
+                              page->pixels + page->dirtyTop * page->width);
+        page->dirtyTop = page->dirtyBottom = 0;
+    }
+}
+
+
+void FTAtlas::Clear()
+{
+    DeletePages();
+
+    entries.resize(0, Entry());
+    owners.resize(0, Owner());
+    freeEntry = -1;
+    freeOwner = -1;
+    entryCount = 0;
+    currentPage = 0;
+    packer.Reset(0, 0);
+    Rehash(buckets.size());
+}
+
+
+void FTAtlas::AddPage(int width, int height, int minWidth, int minHeight)
+{
+    if(!maximumTextureSize)
+    {
+        maximumTextureSize = ftglesMaxTextureSize();
+        if(maximumTextureSize <= 0)
+        {
+            maximumTextureSize = 1024;
+        }
+    }
+
+    if(pageSize)
+    {
+        width = height = NextPowerOf2(pageSize);
+    }
+
+    width = width < minWidth ? NextPowerOf2(minWidth) : width;
+    height = height < minHeight ? NextPowerOf2(minHeight) : height;
+    width = width > maximumTextureSize ? maximumTextureSize : width;
+    height = height > maximumTextureSize ? maximumTextureSize : height;
+
+    if(pageBudget && pages.size() >= pageBudget)
+    {
+        unsigned int oldest = 0;
+
+        for(unsigned int i = 1; i < pages.size(); ++i)
+        {
+            if(pages[i]->lastUsed < pages[oldest]->lastUsed)
+            {
+                oldest = i;
+            }
+        }
+
+        EvictPage(oldest);
+
+        // Grown if it is too small for the glyph wanting room
+        Page *page = pages[oldest];
+        if(page->width < minWidth || page->height < minHeight)
+        {
+            page->width = width > page->width ? width : page->width;
+            page->height = height > page->height ? height : page->height;
+
+            delete[] page->pixels;
+            page->pixels = new unsigned char[page->width * page->height];
+            memset(page->pixels, 0, page->width * page->height);
+            ftglesTextureImage(page->texture, page->width, page->height,
+                               page->pixels);
+            page->dirtyTop = page->dirtyBottom = 0;
+        }
+
+        currentPage = oldest;
+        packer.Reset(page->width, page->height);
+        return;
+    }
+
+    Page *page = new Page;
+    page->texture = ftglesCreateTexture();
+    page->width = width;
+    page->height = height;
+    page->glyphArea = 0;
+    page->lastUsed = renderCount;
+    page->pixels = new unsigned char[width * height];
+    page->dirtyTop = page->dirtyBottom = 0;
+    page->owners = -1;
+
+    memset(page->pixels, 0, width * height);
+    ftglesTextureImage(page->texture, width, height, page->pixels);
+
+    currentPage = pages.size();
+    pages.push_back(page);
+    packer.Reset(width, height);
+}
+
+
+void FTAtlas::EvictPage(unsigned int index)
+{
+    Page *page = pages[index];
+
+    // Quads already batched still sample the old glyphs
+    Upload();
+    ftglesFlush();
+
+    // Each glyph takes all of its records with it, on this page or not
+    while(page->owners >= 0)
+    {
+        Owner owner = owners[page->owners];
+        RemoveOwners(page->owners);
+        owner.font->Evicted(owner.glyph, owner.charCode);
+    }
+
+    for(unsigned int i = 0; i < entries.size(); ++i)
+    {
+        if(entries[i].page == static_cast<int>(index))
+        {
+            entries[i].page = -1;
+            entries[i].next = freeEntry;
+            freeEntry = i;
+            --entryCount;
+        }
+    }
+    Rehash(buckets.size());
+
+    // Cleared on the GL side with the next upload
+    memset(page->pixels, 0, page->width * page->height);
+    page->dirtyTop = 0;
+    page->dirtyBottom = page->height;
+    written = true;
+
+    page->glyphArea = 0;
+    page->lastUsed = renderCount;
+}
+
+
+void FTAtlas::RemoveOwners(int first)
+{
+    int o = first;
+
+    do
+    {
+        Owner& owner = owners[o];
+        int sibling = owner.sibling;
+
+        if(owner.prev >= 0)
+        {
+            owners[owner.prev].next = owner.next;
+        }
+        else
+        {
+            pages[owner.page]->owners = owner.next;
+        }
+
+        if(owner.next >= 0)
+        {
+            owners[owner.next].prev = owner.prev;
+        }
+
+        owner.font = NULL;
+        owner.glyph = NULL;
+        owner.next = freeOwner;
+        freeOwner = o;
+
+        o = sibling;
+    }
+    while(o != first);
+}
+
+
+void FTAtlas::Rehash(unsigned int count)
+{
+    buckets.resize(count, -1);
+    for(unsigned int i = 0; i < count; ++i)
+    {
+        buckets[i] = -1;
+    }
+
+    for(unsigned int e = 0; e < entries.size(); ++e)
+    {
+        if(entries[e].page >= 0)
+        {
+            unsigned int bucket = Hash(entries[e].key) & (count - 1);
+            entries[e].next = buckets[bucket];
+            buckets[bucket] = e;
+        }
+    }
+}
+
+
+void FTAtlas::DeletePages()
+{
+    for(unsigned int i = 0; i < pages.size(); ++i)
+    {
+        ftglesDeleteTextures(1, &pages[i]->texture);
+        delete [] pages[i]->pixels;
+        delete pages[i];
+    }
+
+    pages.clear();
+}
+
+
+float FTAtlas::Occupancy() const
+{
+    long used = 0, total = 0;
+
+    for(unsigned int i = 0; i < pages.size(); ++i)
+    {
+        used += pages[i]->glyphArea;
+        total += static_cast<long>(pages[i]->width) * pages[i]->height;
+    }
+
+    return total ? static_cast<float>(used) / total : 0.0f;
+}
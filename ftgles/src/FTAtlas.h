@@ -0,0 +1,336 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __FTAtlas__
+#define __FTAtlas__
+
+#include "FTGL/ftgles.h"
+#include "FTGL/ftglesGlue.h"
+
+#include "FTVector.h"
+#include "FTSkyline.h"
+
+class FTGlyph;
+class FTTextureFontImpl;
+
+
+/**
+ * Identifies a glyph bitmap: the face it came from, the scale it was
+ * rasterised at, its glyph index and how it was made.
+ */
+struct FTAtlasKey
+{
+    unsigned long face;
+    long xScale, yScale;
+    unsigned int glyph;
+
+    /**
+     * How the bitmap was made: FTAtlas::COVERAGE, FTAtlas::DISTANCE, or
+     * FTAtlas::SHIFTED plus the shift.
+     */
+    unsigned int variant;
+};
+
+
+/**
+ * FTAtlas holds the texture pages glyph bitmaps are packed into. Every
+ * FTTextureFont has one; fonts registered with an FTAtlasManager share
+ * its atlas instead, so a bitmap packed by one font is reused by any
+ * other font with the same face and size.
+ *
+ * The atlas is reference counted by the fonts and manager using it.
+ */
+class FTAtlas
+{
+    public:
+        /**
+         * Glyph bitmap variants.
+         */
+        enum
+        {
+            COVERAGE = 0,
+            DISTANCE = 1,
+
+            /**
+             * Coverage rasterised n 64ths of a pixel right of the pen is
+             * SHIFTED + n, n from 1 to 63.
+             */
+            SHIFTED = 64
+        };
+
+        /**
+         * Where a glyph bitmap lives.
+         */
+        struct Page
+        {
+            GLuint texture;
+            int width, height;
+            long glyphArea;
+            unsigned int lastUsed;
+
+            /**
+             * A copy of the texture. Glyphs are written here, and the rows
+             * from dirtyTop up to dirtyBottom uploaded together.
+             */
+            unsigned char *pixels;
+            int dirtyTop, dirtyBottom;
+
+            /**
+             * The first record of a glyph using the page, or -1.
+             */
+            int owners;
+        };
+
+        FTAtlas();
+
+        void Retain();
+
+        /**
+         * Drop a reference, deleting the atlas and its textures with the
+         * last one.
+         */
+        void Release();
+
+        /**
+         * Find a packed bitmap, or make room for a new one. When the page
+         * budget is full the least recently used page is emptied first,
+         * unloading its glyphs from every font holding them.
+         *
+         * @param key  Identifies the bitmap.
+         * @param width  Bitmap width, padding included.
+         * @param height  Bitmap height, padding included.
+         * @param pageWidth  Suggested size of a new page, if one is needed
+         *                   and no page size is set.
+         * @param pageHeight  Suggested size of a new page.
+         * @param x  Set to the left of the bitmap's space.
+         * @param y  Set to the top of the bitmap's space.
+         * @return  The slot's entry, whose page is Entry(n).page. found is
+         *          set if the bitmap was already packed.
+         */
+        int Place(const FTAtlasKey& key, int width, int height,
+                  int pageWidth, int pageHeight, int& x, int& y,
+                  bool& found);
+
+        /**
+         * @return  The entry of a registered bitmap, or -1.
+         */
+        int Find(const FTAtlasKey& key) const;
+
+        /**
+         * Add a page filled from elsewhere, such as a cache file. Glyphs are
+         * not packed into it later.
+         *
+         * @return  The page's index.
+         */
+        int AdoptPage(int width, int height, const unsigned char* pixels);
+
+        /**
+         * Register a bitmap already in a page. If one with the same key is
+         * registered, page, x and y are set to where that one is instead.
+         *
+         * @param key  Identifies the bitmap.
+         * @param page  The page holding the bitmap.
+         * @param x  The left of the bitmap's space, padding included.
+         * @param y  The top of the bitmap's space.
+         * @param width  Bitmap width, padding included.
+         * @param height  Bitmap height, padding included.
+         * @return  The bitmap's entry.
+         */
+        int Adopt(const FTAtlasKey& key, int& page, int& x, int& y,
+                  int width, int height);
+
+        /**
+         * @return  The index of the page using a texture, or -1.
+         */
+        int PageIndex(GLuint texture) const;
+
+        Page* PageAt(int index) { return pages[index]; }
+
+        /**
+         * Record that a font's glyph uses an entry, so it can be unloaded
+         * when the entry's page is evicted or the font changes atlas. An
+         * entry of -1 is a glyph with no bitmap, which is not recorded.
+         *
+         * @param entry  The entry used.
+         * @param font  The font holding the glyph.
+         * @param glyph  The glyph.
+         * @param charCode  The character the glyph was made for.
+         * @param first  What this returned for the glyph's first entry, or
+         *               -1 if this is the first.
+         * @return  The glyph's first record, to pass for its other entries,
+         *          or -1 if it has none.
+         */
+        int AddOwner(int entry, FTTextureFontImpl* font, FTGlyph* glyph,
+                     unsigned int charCode, int first);
+
+        /**
+         * Forget every glyph a font has registered. The bitmaps stay packed
+         * for other fonts and later use.
+         *
+         * @param font  The font.
+         * @param unload  Also unload the glyphs from the font.
+         */
+        void ReleaseFont(FTTextureFontImpl* font, bool unload);
+
+        /**
+         * Forget which of a font's glyphs use bitmaps rasterised at a
+         * scale, as the font is deleting them. The bitmaps stay.
+         */
+        void ReleaseScale(FTTextureFontImpl* font, long xScale, long yScale);
+
+        /**
+         * Copy a glyph bitmap into the page holding an entry. It reaches
+         * the texture at the next Upload().
+         *
+         * @param entry  The entry returned by Place.
+         * @param x  The left of the bitmap in the page.
+         * @param y  The top of the bitmap in the page.
+         * @param pixels  An 8 bit grey bitmap.
+         * @param width  Bitmap width.
+         * @param rows  Bitmap height.
+         * @param pitch  Bytes from one row to the next; negative if the
+         *               rows are stored bottom up.
+         */
+        void Write(int entry, int x, int y, const unsigned char* pixels,
+                   int width, int rows, int pitch);
+
+        /**
+         * Upload the rows of every page written since the last upload,
+         * one call per page. Nothing is done if no page was written.
+         */
+        void Upload();
+
+        /**
+         * Delete every page and forget every bitmap. Only for an atlas with
+         * no glyphs registered.
+         */
+        void Clear();
+
+        /**
+         * The texture glyphs are currently packed into, or 0.
+         */
+        GLuint CurrentTexture() const
+        {
+            return pages.empty() ? 0 : pages[currentPage]->texture;
+        }
+
+        Page* EntryPage(int entry) { return pages[entries[entry].page]; }
+
+        /**
+         * The render count glyphs stamp their page with.
+         */
+        const unsigned int* Clock() const { return &renderCount; }
+
+        void Tick() { ++renderCount; }
+
+        void PageSize(unsigned int size) { pageSize = size; }
+
+        void PageBudget(unsigned int budget) { pageBudget = budget; }
+
+        unsigned int PageCount() const { return pages.size(); }
+
+        float Occupancy() const;
+
+    private:
+        ~FTAtlas();
+
+        struct Entry
+        {
+            FTAtlasKey key;
+            int page;
+            int x, y;
+            int next;
+        };
+
+        /**
+         * A glyph's use of an entry. Records are listed per page through
+         * prev and next, and the records of one glyph form a ring through
+         * sibling. Free records have no font and are chained from
+         * freeOwner through next.
+         */
+        struct Owner
+        {
+            FTTextureFontImpl* font;
+            FTGlyph* glyph;
+            unsigned int charCode;
+            int entry;
+            int page;
+            int prev, next;
+            int sibling;
+        };
+
+        static unsigned int Hash(const FTAtlasKey& key);
+
+        int AddEntry(const FTAtlasKey& key, int page, int x, int y);
+
+        /**
+         * Start a new page, or reuse the least recently used one once the
+         * budget is reached. The page is made at least minWidth by
+         * minHeight, up to the largest texture, for a glyph larger than
+         * the page size.
+         */
+        void AddPage(int width, int height, int minWidth = 0,
+                     int minHeight = 0);
+
+        void EvictPage(unsigned int page);
+
+        /**
+         * Drop every record of the glyph owning a record.
+         */
+        void RemoveOwners(int owner);
+
+        void Rehash(unsigned int buckets);
+
+        void DeletePages();
+
+        int refs;
+
+        FTVector<Page*> pages;
+        unsigned int currentPage;
+        FTSkyline packer;
+
+        /**
+         * Bitmaps packed so far, chained from hash buckets. Free entries
+         * have a page of -1 and are chained from freeEntry.
+         */
+        FTVector<Entry> entries;
+        FTVector<int> buckets;
+        int freeEntry;
+        unsigned int entryCount;
+
+        FTVector<Owner> owners;
+        int freeOwner;
+
+        unsigned int pageSize;
+        unsigned int pageBudget;
+        GLsizei maximumTextureSize;
+        unsigned int renderCount;
+
+        /**
+         * Set when a page is written, cleared by Upload().
+         */
+        bool written;
+};
+
+#endif  //  __FTAtlas__
@@ -0,0 +1,128 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#include "config.h"
+
+#include "FTInternals.h"
+#include "FTAtlas.h"
+
+
+//
+//  FTAtlasManager
+//
+
+
+FTAtlasManager::FTAtlasManager()
+{
+    impl = new FTAtlas;
+}
+
+
+FTAtlasManager::~FTAtlasManager()
+{
+    impl->Release();
+}
+
+
+void FTAtlasManager::PageSize(unsigned int size)
+{
+    impl->PageSize(size);
+}
+
+
+void FTAtlasManager::PageBudget(unsigned int pages)
+{
+    impl->PageBudget(pages);
+}
+
+
+unsigned int FTAtlasManager::PageCount() const
+{
+    return impl->PageCount();
+}
+
+
+float FTAtlasManager::Occupancy() const
+{
+    return impl->Occupancy();
+}
+
+
+FTGL_BEGIN_C_DECLS
+
+FTGLatlas *ftglCreateAtlasManager(void)
+{
+    FTGLatlas *ftgl = (FTGLatlas *)malloc(sizeof(FTGLatlas));
+    ftgl->ptr = new FTAtlasManager;
+    return ftgl;
+}
+
+
+void ftglDestroyAtlasManager(FTGLatlas *a)
+{
+    if(!a || !a->ptr)
+    {
+        fprintf(stderr, "FTGL warning: NULL pointer in %s\n", __FUNCTION__);
+        return;
+    }
+    delete a->ptr;
+    free(a);
+}
+
+
+#define C_FUN(cname, cargs, cxxname, cxxarg) \
+    void cname cargs \
+    { \
+        if(!a || !a->ptr) \
+        { \
+            fprintf(stderr, "FTGL warning: NULL pointer in %s\n", #cname); \
+            return; \
+        } \
+        a->ptr->cxxname cxxarg; \
+    }
+
+// void FTAtlasManager::PageSize(unsigned int size);
+C_FUN(ftglSetAtlasPageSize, (FTGLatlas *a, unsigned int size),
+      PageSize, (size));
+
+// void FTAtlasManager::PageBudget(unsigned int pages);
+C_FUN(ftglSetAtlasPageBudget, (FTGLatlas *a, unsigned int pages),
+      PageBudget, (pages));
+
+
+void ftglSetFontAtlasManager(FTGLfont *f, FTGLatlas *a)
+{
+    FTTextureFont *font = f ? dynamic_cast<FTTextureFont *>(f->ptr) : NULL;
+
+    if(!font)
+    {
+        fprintf(stderr, "FTGL warning: not a texture font in %s\n",
+                __FUNCTION__);
+        return;
+    }
+
+    font->AtlasManager(a ? a->ptr : NULL);
+}
+
+FTGL_END_C_DECLS
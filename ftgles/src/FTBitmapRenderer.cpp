@@ -0,0 +1,398 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#include "config.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "FTInternals.h"
+#include "FTBitmapRendererImpl.h"
+
+
+/**
+ * A font whose glyphs draw into a renderer's buffer. It makes no OpenGL
+ * calls.
+ */
+class FTBitmapRendererFont : public FTFont
+{
+    public:
+        FTBitmapRendererFont(const char* fontFilePath, FTBuffer* target) :
+            FTFont(fontFilePath),
+            buffer(target)
+        {
+            GlyphLoadFlags(FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP);
+        }
+
+        FTBitmapRendererFont(const unsigned char *pBufferBytes,
+                             size_t bufferSizeInBytes, FTBuffer* target) :
+            FTFont(pBufferBytes, bufferSizeInBytes),
+            buffer(target)
+        {
+            GlyphLoadFlags(FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP);
+        }
+
+    protected:
+        virtual FTGlyph* MakeGlyph(FT_GlyphSlot slot)
+        {
+            return new FTBufferGlyph(slot, buffer);
+        }
+
+    private:
+        FTBuffer* buffer;
+};
+
+
+//
+//  FTBitmapRenderer
+//
+
+
+FTBitmapRenderer::FTBitmapRenderer(const char* fontFilePath) :
+    impl(new FTBitmapRendererImpl(fontFilePath))
+{}
+
+
+FTBitmapRenderer::FTBitmapRenderer(const unsigned char *pBufferBytes,
+                                   size_t bufferSizeInBytes) :
+    impl(new FTBitmapRendererImpl(pBufferBytes, bufferSizeInBytes))
+{}
+
+
+FTBitmapRenderer::~FTBitmapRenderer()
+{
+    delete impl;
+}
+
+
+FT_Error FTBitmapRenderer::Error() const
+{
+    return impl->font->Error();
+}
+
+
+FTFont* FTBitmapRenderer::Font()
+{
+    return impl->font;
+}
+
+
+void FTBitmapRenderer::Target(void* pixels, int width, int height,
+                              int stride, FTGL::PixelFormat format)
+{
+    impl->target = static_cast<unsigned char*>(pixels);
+    impl->targetWidth = pixels ? width : 0;
+    impl->targetHeight = pixels ? height : 0;
+    impl->targetStride = stride;
+    impl->format = format;
+}
+
+
+void FTBitmapRenderer::Color(unsigned char red, unsigned char green,
+                             unsigned char blue, unsigned char alpha)
+{
+    impl->color[0] = red;
+    impl->color[1] = green;
+    impl->color[2] = blue;
+    impl->color[3] = alpha;
+}
+
+
+FTPoint FTBitmapRenderer::Render(const char* string, const int len,
+                                 FTPoint position, FTPoint spacing)
+{
+    return impl->RenderI(string, len, position, spacing);
+}
+
+
+FTPoint FTBitmapRenderer::Render(const wchar_t* string, const int len,
+                                 FTPoint position, FTPoint spacing)
+{
+    return impl->RenderI(string, len, position, spacing);
+}
+
+
+void FTBitmapRenderer::Render(FTLayout& layout, const char* string,
+                              const int len, FTPoint position)
+{
+    impl->RenderLayoutI(layout, string, len, position);
+}
+
+
+void FTBitmapRenderer::Render(FTLayout& layout, const wchar_t* string,
+                              const int len, FTPoint position)
+{
+    impl->RenderLayoutI(layout, string, len, position);
+}
+
+
+//
+//  FTBitmapRendererImpl
+//
+
+
+FTBitmapRendererImpl::FTBitmapRendererImpl(const char* fontFilePath) :
+    left(0),
+    bottom(0),
+    font(new FTBitmapRendererFont(fontFilePath, &buffer)),
+    target(NULL),
+    targetWidth(0),
+    targetHeight(0),
+    targetStride(0),
+    format(FTGL::PIXEL_A8)
+{
+    memset(color, 255, sizeof(color));
+}
+
+
+FTBitmapRendererImpl::FTBitmapRendererImpl(const unsigned char *pBufferBytes,
+                                           size_t bufferSizeInBytes) :
+    left(0),
+    bottom(0),
+    font(new FTBitmapRendererFont(pBufferBytes, bufferSizeInBytes, &buffer)),
+    target(NULL),
+    targetWidth(0),
+    targetHeight(0),
+    targetStride(0),
+    format(FTGL::PIXEL_A8)
+{
+    memset(color, 255, sizeof(color));
+}
+
+
+FTBitmapRendererImpl::~FTBitmapRendererImpl()
+{
+    delete font;
+}
+
+
+bool FTBitmapRendererImpl::Begin(const FTBBox& box)
+{
+    // A pixel of margin for antialiasing outside the outline's box, then
+    // only the part inside the target
+    int x0 = (int)floorf(box.Lower().Xf()) - 1;
+    int y0 = (int)floorf(box.Lower().Yf()) - 1;
+    int x1 = (int)ceilf(box.Upper().Xf()) + 1;
+    int y1 = (int)ceilf(box.Upper().Yf()) + 1;
+
+    x0 = x0 < 0 ? 0 : x0;
+    y0 = y0 < 0 ? 0 : y0;
+    x1 = x1 > targetWidth ? targetWidth : x1;
+    y1 = y1 > targetHeight ? targetHeight : y1;
+
+    if(x0 >= x1 || y0 >= y1)
+    {
+        // Glyphs still advance the pen, but draw nothing
+        buffer.Size(0, 0);
+        return false;
+    }
+
+    buffer.Size(x1 - x0, y1 - y0);
+    buffer.Pos(FTPoint(-x0, -y0));
+
+    left = x0;
+    bottom = y0;
+
+    return true;
+}
+
+
+void FTBitmapRendererImpl::Composite()
+{
+    const int width = buffer.Width();
+    const int height = buffer.Height();
+
+    for(int y = 0; y < height; y++)
+    {
+        // The buffer's top row is the highest in the target
+        const unsigned char *src = buffer.Pixels() + y * width;
+        unsigned char *dest = target
+                            + (targetHeight - bottom - height + y) * targetStride;
+
+        if(format == FTGL::PIXEL_A8)
+        {
+            dest += left;
+
+            for(int x = 0; x < width; x++)
+            {
+                dest[x] = src[x] > dest[x] ? src[x] : dest[x];
+            }
+
+            continue;
+        }
+
+        dest += left * 4;
+
+        for(int x = 0; x < width; x++, dest += 4)
+        {
+            unsigned int a = (src[x] * color[3] + 127) / 255;
+
+            if(!a)
+            {
+                continue;
+            }
+
+            // Non-premultiplied "over"
+            unsigned int below = (dest[3] * (255 - a) + 127) / 255;
+            unsigned int out = a + below;
+
+            for(int c = 0; c < 3; c++)
+            {
+                dest[c] = (color[c] * a + dest[c] * below + out / 2) / out;
+            }
+            dest[3] = out;
+        }
+    }
+}
+
+
+template <typename T>
+inline FTPoint FTBitmapRendererImpl::RenderI(const T* string, const int len,
+                                             FTPoint position, FTPoint spacing)
+{
+    bool visible = Begin(font->BBox(string, len, position, spacing));
+
+    position = font->Render(string, len, position, spacing);
+
+    if(visible)
+    {
+        Composite();
+    }
+
+    return position;
+}
+
+
+template <typename T>
+inline void FTBitmapRendererImpl::RenderLayoutI(FTLayout& layout,
+                                                const T* string,
+                                                const int len,
+                                                FTPoint position)
+{
+    // Layouts lay text out from the origin and leave moving it to the
+    // caller, as the modelview matrix would under OpenGL, so the buffer's
+    // origin is moved to the position instead
+    FTBBox box = layout.BBox(string, len);
+    box += position;
+
+    if(Begin(box))
+    {
+        buffer.Pos(buffer.Pos() + position);
+        layout.Render(string, len);
+        Composite();
+    }
+}
+
+
+//
+//  C API
+//
+
+
+FTGL_BEGIN_C_DECLS
+
+FTGLbitmaprenderer *ftglCreateBitmapRenderer(const char *file)
+{
+    FTBitmapRenderer *r = new FTBitmapRenderer(file);
+    if(r->Error())
+    {
+        delete r;
+        return NULL;
+    }
+
+    FTGLbitmaprenderer *ftgl =
+        (FTGLbitmaprenderer *)malloc(sizeof(FTGLbitmaprenderer));
+    ftgl->ptr = r;
+    ftgl->font.ptr = r->Font();
+    ftgl->font.type = FONT_CUSTOM;
+    return ftgl;
+}
+
+
+void ftglDestroyBitmapRenderer(FTGLbitmaprenderer *r)
+{
+    if(!r || !r->ptr)
+    {
+        fprintf(stderr, "FTGL warning: NULL pointer in %s\n", __FUNCTION__);
+        return;
+    }
+    delete r->ptr;
+    free(r);
+}
+
+
+FTGLfont *ftglGetBitmapRendererFont(FTGLbitmaprenderer *r)
+{
+    if(!r || !r->ptr)
+    {
+        fprintf(stderr, "FTGL warning: NULL pointer in %s\n", __FUNCTION__);
+        return NULL;
+    }
+    return &r->font;
+}
+
+
+#define C_FUN(cname, cargs, cxxname, cxxarg) \
+    void cname cargs \
+    { \
+        if(!r || !r->ptr) \
+        { \
+            fprintf(stderr, "FTGL warning: NULL pointer in %s\n", #cname); \
+            return; \
+        } \
+        r->ptr->cxxname cxxarg; \
+    }
+
+// void FTBitmapRenderer::Target(void* pixels, int width, int height,
+//                               int stride, FTGL::PixelFormat format);
+C_FUN(ftglSetBitmapRendererTarget, (FTGLbitmaprenderer *r, void *pixels,
+                                    int width, int height, int stride,
+                                    int format),
+      Target, (pixels, width, height, stride, (FTGL::PixelFormat)format));
+
+// void FTBitmapRenderer::Color(unsigned char red, unsigned char green,
+//                              unsigned char blue, unsigned char alpha);
+C_FUN(ftglSetBitmapRendererColor, (FTGLbitmaprenderer *r, unsigned char red,
+                                   unsigned char green, unsigned char blue,
+                                   unsigned char alpha),
+      Color, (red, green, blue, alpha));
+
+// FTPoint FTBitmapRenderer::Render(const char* string, const int len,
+//                                  FTPoint position, FTPoint spacing);
+C_FUN(ftglRenderBitmapText, (FTGLbitmaprenderer *r, const char *string,
+                             float x, float y),
+      Render, (string, -1, FTPoint(x, y)));
+
+void ftglRenderBitmapLayout(FTGLbitmaprenderer *r, FTGLlayout *l,
+                            const char *string, float x, float y)
+{
+    if(!r || !r->ptr || !l || !l->ptr)
+    {
+        fprintf(stderr, "FTGL warning: NULL pointer in %s\n", __FUNCTION__);
+        return;
+    }
+    r->ptr->Render(*l->ptr, string, -1, FTPoint(x, y));
+}
+
+FTGL_END_C_DECLS
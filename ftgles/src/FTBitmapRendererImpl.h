@@ -0,0 +1,84 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __FTBitmapRendererImpl__
+#define __FTBitmapRendererImpl__
+
+#include "FTGL/ftgles.h"
+
+class FTBitmapRendererImpl
+{
+        friend class FTBitmapRenderer;
+
+    protected:
+        FTBitmapRendererImpl(const char* fontFilePath);
+
+        FTBitmapRendererImpl(const unsigned char *pBufferBytes,
+                             size_t bufferSizeInBytes);
+
+        ~FTBitmapRendererImpl();
+
+        /**
+         * Clear the scratch buffer over the part of the target a box
+         * covers, and set its pen so glyphs land there.
+         *
+         * @return  <code>false</code> if the box misses the target.
+         */
+        bool Begin(const FTBBox& box);
+
+        /**
+         * Composite the scratch buffer into the target.
+         */
+        void Composite();
+
+    private:
+        /* Internal generic Render() implementation */
+        template <typename T>
+        inline FTPoint RenderI(const T *s, const int len,
+                               FTPoint position, FTPoint spacing);
+
+        /* Internal generic Render() with a layout implementation */
+        template <typename T>
+        inline void RenderLayoutI(FTLayout& layout, const T *s,
+                                  const int len, FTPoint position);
+
+        /**
+         * The buffer glyphs are drawn into, and the target pixel its
+         * bottom left corner lands on, counting up from the bottom.
+         */
+        FTBuffer buffer;
+        int left, bottom;
+
+        /**
+         * A font making FTBufferGlyphs that draw into the buffer.
+         */
+        FTFont* font;
+
+        unsigned char* target;
+        int targetWidth, targetHeight, targetStride;
+        FTGL::PixelFormat format;
+        unsigned char color[4];
+};
+
+#endif  //  __FTBitmapRendererImpl__
@@ -32,6 +32,11 @@ FTBuffer::FTBuffer()
  : width(0),
    height(0),
    pixels(0),
+   capacity(0),
+   dirtyLeft(0),
+   dirtyTop(0),
+   dirtyRight(0),
+   dirtyBottom(0),
    pos(FTPoint())
 {
 }
@@ -48,22 +53,63 @@ FTBuffer::~FTBuffer()
 
 void FTBuffer::Size(int w, int h)
 {
-    if(w == width && h == height)
+    // Clear what was written, in the layout it was written in
+    if(dirtyTop < dirtyBottom && dirtyLeft == 0 && dirtyRight == width)
     {
-        return;
+        memset(pixels + dirtyTop * width, 0,
+               (dirtyBottom - dirtyTop) * width);
+    }
+    else
+    {
+        for(int y = dirtyTop; y < dirtyBottom; y++)
+        {
+            memset(pixels + y * width + dirtyLeft, 0, dirtyRight - dirtyLeft);
+        }
     }
 
-    if(w * h != width * height)
+    dirtyLeft = dirtyTop = dirtyRight = dirtyBottom = 0;
+
+    // The whole allocation is zero now, so it suits any smaller size
+    if(w * h > capacity)
     {
         if(pixels)
         {
             delete[] pixels;
         }
         pixels = new unsigned char[w * h];
+        memset(pixels, 0, w * h);
+        capacity = w * h;
     }
 
-    memset(pixels, 0, w * h);
     width = w;
     height = h;
 }
 
+
+void FTBuffer::Dirty(int x, int y, int w, int h)
+{
+    int right = x + w > width ? width : x + w;
+    int bottom = y + h > height ? height : y + h;
+    x = x < 0 ? 0 : x;
+    y = y < 0 ? 0 : y;
+
+    if(x >= right || y >= bottom)
+    {
+        return;
+    }
+
+    if(dirtyLeft == dirtyRight)
+    {
+        dirtyLeft = x;
+        dirtyTop = y;
+        dirtyRight = right;
+        dirtyBottom = bottom;
+        return;
+    }
+
+    dirtyLeft = x < dirtyLeft ? x : dirtyLeft;
+    dirtyTop = y < dirtyTop ? y : dirtyTop;
+    dirtyRight = right > dirtyRight ? right : dirtyRight;
+    dirtyBottom = bottom > dirtyBottom ? bottom : dirtyBottom;
+}
+
@@ -98,7 +98,10 @@ class FTCharToGlyphIndexMap
 
         const GlyphIndex find(CharacterCode c)
         {
-            if(!this->Indices)
+            // Codes past the last bucket are never inserted
+            if(!this->Indices
+               || c >= static_cast<CharacterCode>(FTCharToGlyphIndexMap::NumberOfBuckets)
+                       * FTCharToGlyphIndexMap::BucketSize)
             {
                 return 0;
             }
@@ -0,0 +1,153 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#include "config.h"
+
+#include <math.h>
+
+#include "FTDistanceField.h"
+
+
+// Far enough that any real offset is nearer, small enough not to overflow
+static const int FAR = 1 << 12;
+
+
+static inline int Length2(int dx, int dy)
+{
+    return dx * dx + dy * dy;
+}
+
+
+void FTDistanceField::Generate(const unsigned char* coverage, int width,
+                               int height, int pitch, int spread,
+                               unsigned char* field)
+{
+    int fieldWidth = FieldSize(width, spread);
+    int fieldHeight = FieldSize(height, spread);
+    unsigned int count = fieldWidth * fieldHeight;
+
+    Offset seed = { 0, 0 };
+    Offset far = { FAR, FAR };
+    inside.resize(count, far);
+    outside.resize(count, far);
+
+    for(int y = 0; y < fieldHeight; ++y)
+    {
+        int row = y - spread;
+        const unsigned char *src = NULL;
+
+        if(row >= 0 && row < height)
+        {
+            src = pitch >= 0 ? coverage + row * pitch
+                             : coverage + (height - 1 - row) * -pitch;
+        }
+
+        for(int x = 0; x < fieldWidth; ++x)
+        {
+            int column = x - spread;
+            bool in = src && column >= 0 && column < width
+                      && src[column] >= 128;
+
+            inside[y * fieldWidth + x] = in ? seed : far;
+            outside[y * fieldWidth + x] = in ? far : seed;
+        }
+    }
+
+    Sweep(&inside[0], fieldWidth, fieldHeight);
+    Sweep(&outside[0], fieldWidth, fieldHeight);
+
+    for(unsigned int i = 0; i < count; ++i)
+    {
+        // Texel centres on either side of the edge are a texel apart, so
+        // the edge itself is half a texel from each.
+        float d;
+        if(outside[i].dx || outside[i].dy)
+        {
+            d = sqrtf(Length2(outside[i].dx, outside[i].dy)) - 0.5f;
+        }
+        else
+        {
+            d = 0.5f - sqrtf(Length2(inside[i].dx, inside[i].dy));
+        }
+
+        int value = static_cast<int>(128.0f + d * 128.0f / spread + 0.5f);
+        field[i] = value < 0 ? 0 : value > 255 ? 255 : value;
+    }
+}
+
+
+void FTDistanceField::Compare(Offset* grid, int width, int x, int y,
+                              int ox, int oy)
+{
+    Offset& here = grid[y * width + x];
+    const Offset& other = grid[(y + oy) * width + x + ox];
+    int dx = other.dx + ox;
+    int dy = other.dy + oy;
+
+    if(Length2(dx, dy) < Length2(here.dx, here.dy))
+    {
+        here.dx = dx;
+        here.dy = dy;
+    }
+}
+
+
+void FTDistanceField::Sweep(Offset* grid, int width, int height)
+{
+    for(int y = 0; y < height; ++y)
+    {
+        for(int x = 0; x < width; ++x)
+        {
+            if(x > 0) Compare(grid, width, x, y, -1, 0);
+            if(y > 0)
+            {
+                Compare(grid, width, x, y, 0, -1);
+                if(x > 0) Compare(grid, width, x, y, -1, -1);
+                if(x < width - 1) Compare(grid, width, x, y, 1, -1);
+            }
+        }
+        for(int x = width - 2; x >= 0; --x)
+        {
+            Compare(grid, width, x, y, 1, 0);
+        }
+    }
+
+    for(int y = height - 1; y >= 0; --y)
+    {
+        for(int x = width - 1; x >= 0; --x)
+        {
+            if(x < width - 1) Compare(grid, width, x, y, 1, 0);
+            if(y < height - 1)
+            {
+                Compare(grid, width, x, y, 0, 1);
+                if(x > 0) Compare(grid, width, x, y, -1, 1);
+                if(x < width - 1) Compare(grid, width, x, y, 1, 1);
+            }
+        }
+        for(int x = 1; x < width; ++x)
+        {
+            Compare(grid, width, x, y, -1, 0);
+        }
+    }
+}
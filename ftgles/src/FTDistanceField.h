@@ -0,0 +1,97 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __FTDistanceField__
+#define __FTDistanceField__
+
+#include "FTVector.h"
+
+
+/**
+ * FTDistanceField turns a glyph's coverage bitmap into a signed distance
+ * field: each texel holds the distance to the glyph's edge, 128 on the
+ * edge, rising to 255 inside and falling to 0 outside. Sampled with
+ * linear filtering and cut at 128, the field gives a sharp edge at any
+ * scale.
+ *
+ * Distances are found with an 8 point sequential Euclidean distance
+ * transform, so the field costs two passes over the texels.
+ */
+class FTDistanceField
+{
+    public:
+        /**
+         * The field is larger than the bitmap by the spread on each side,
+         * so distances outside the glyph fit.
+         *
+         * @param size  The bitmap width or height.
+         * @param spread  The distance in texels that maps to 0 or 255.
+         * @return  The field width or height.
+         */
+        static int FieldSize(int size, int spread)
+        {
+            return size + 2 * spread;
+        }
+
+        /**
+         * Build a field.
+         *
+         * @param coverage  An 8 bit grey bitmap; 128 and up is inside.
+         * @param width  Bitmap width.
+         * @param height  Bitmap height.
+         * @param pitch  Bytes from one bitmap row to the next; negative
+         *               if the rows are stored bottom up.
+         * @param spread  The distance in texels that maps to 0 or 255.
+         * @param field  FieldSize(width) by FieldSize(height) bytes for
+         *               the field, rows top down.
+         */
+        void Generate(const unsigned char* coverage, int width, int height,
+                      int pitch, int spread, unsigned char* field);
+
+    private:
+        /**
+         * The offset from a texel to the nearest seed texel.
+         */
+        struct Offset
+        {
+            int dx, dy;
+        };
+
+        /**
+         * Spread seed offsets across the grid in a forward and a backward
+         * pass.
+         */
+        static void Sweep(Offset* grid, int width, int height);
+
+        static inline void Compare(Offset* grid, int width, int x, int y,
+                                   int ox, int oy);
+
+        /**
+         * Offsets to the nearest inside and outside texels.
+         */
+        FTVector<Offset> inside;
+        FTVector<Offset> outside;
+};
+
+#endif  //  __FTDistanceField__
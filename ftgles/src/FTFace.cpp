@@ -40,8 +40,11 @@ FTFace::FTFace(const char* fontFilePath, bool precomputeKerning)
     const FT_Long DEFAULT_FACE_INDEX = 0;
     ftFace = new FT_Face;
 
-    err = FT_New_Face(*FTLibrary::Instance().GetLibrary(), fontFilePath,
+    const FTLibrary& library = FTLibrary::Instance();
+    library.Lock();
+    err = FT_New_Face(*library.GetLibrary(), fontFilePath,
                       DEFAULT_FACE_INDEX, ftFace);
+    library.Unlock();
 	
     if(err)
     {
@@ -70,9 +73,12 @@ FTFace::FTFace(const unsigned char *pBufferBytes, size_t bufferSizeInBytes,
     const FT_Long DEFAULT_FACE_INDEX = 0;
     ftFace = new FT_Face;
 
-    err = FT_New_Memory_Face(*FTLibrary::Instance().GetLibrary(),
+    const FTLibrary& library = FTLibrary::Instance();
+    library.Lock();
+    err = FT_New_Memory_Face(*library.GetLibrary(),
                              (FT_Byte const *)pBufferBytes, (FT_Long)bufferSizeInBytes,
                              DEFAULT_FACE_INDEX, ftFace);
+    library.Unlock();
     if(err)
     {
         delete ftFace;
@@ -99,7 +105,10 @@ FTFace::~FTFace()
 
     if(ftFace)
     {
+        const FTLibrary& library = FTLibrary::Instance();
+        library.Lock();
         FT_Done_Face(*ftFace);
+        library.Unlock();
         delete ftFace;
         ftFace = 0;
     }
@@ -129,13 +138,70 @@ bool FTFace::Attach(const unsigned char *pBufferBytes,
 
 const FTSize& FTFace::Size(const unsigned int size, const unsigned int res)
 {
-    charSize.CharSize(ftFace, size, res, res);
-    err = charSize.Error();
+    int index = FindSize(size, res);
 
+    if(index >= 0)
+    {
+        sizes[index].Activate();
+        err = sizes[index].Error();
+        if(!err)
+        {
+            charSize = sizes[index];
+        }
+        return charSize;
+    }
+
+    FTSize newSize;
+    newSize.CharSize(ftFace, size, res, res);
+    err = newSize.Error();
+
+    if(err)
+    {
+        // Go back to the size in use before
+        charSize.Activate();
+        return charSize;
+    }
+
+    sizes.push_back(newSize);
+    charSize = newSize;
     return charSize;
 }
 
 
+void FTFace::ReleaseSize(const unsigned int size, const unsigned int res)
+{
+    int index = FindSize(size, res);
+
+    if(index < 0)
+    {
+        return;
+    }
+
+    if(charSize.CharSize() == size && charSize.Resolution() == res)
+    {
+        charSize = FTSize();
+    }
+
+    sizes[index].Release();
+    sizes[index] = sizes[sizes.size() - 1];
+    sizes.resize(sizes.size() - 1, FTSize());
+}
+
+
+int FTFace::FindSize(const unsigned int size, const unsigned int res) const
+{
+    for(unsigned int i = 0; i < sizes.size(); ++i)
+    {
+        if(sizes[i].CharSize() == size && sizes[i].Resolution() == res)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
 unsigned int FTFace::CharMapCount() const
 {
     return (*ftFace)->num_charmaps;
@@ -33,6 +33,7 @@
 #include "FTGL/ftgles.h"
 
 #include "FTSize.h"
+#include "FTVector.h"
 
 /**
  * FTFace class provides an abstraction layer for the Freetype Face.
@@ -96,6 +97,9 @@ class FTFace
         /**
          * Sets the char size for the current face.
          *
+         * Sizes are kept until released, so setting one again only makes
+         * it active.
+         *
          * This doesn't guarantee that the size was set correctly. Clients
          * should check errors.
          *
@@ -105,6 +109,15 @@ class FTFace
          */
         const FTSize& Size(const unsigned int size, const unsigned int res);
 
+        /**
+         * Free a size set with Size. If it was active, no size is active
+         * until Size is called again.
+         *
+         * @param size      the face size in points (1/72 inch)
+         * @param res       the resolution of the target device.
+         */
+        void ReleaseSize(const unsigned int size, const unsigned int res);
+
         /**
          * Get the number of character maps in this face.
          *
@@ -152,6 +165,13 @@ class FTFace
          */
         FTSize  charSize;
 
+        /**
+         * Every size set and not yet released
+         */
+        FTVector<FTSize> sizes;
+
+        int FindSize(const unsigned int size, const unsigned int res) const;
+
         /**
          * The number of glyphs in this face
          */
@@ -31,6 +31,7 @@
 
 #include "FTInternals.h"
 #include "FTBufferFontImpl.h"
+#include "FTUnicode.h"
 
 
 //
@@ -53,6 +54,16 @@ FTBufferFont::~FTBufferFont()
 {}
 
 
+void FTBufferFont::CacheSize(unsigned int strings, size_t bytes)
+{
+    FTBufferFontImpl *myimpl = dynamic_cast<FTBufferFontImpl *>(impl);
+    if(myimpl)
+    {
+        myimpl->CacheSize(strings, bytes);
+    }
+}
+
+
 FTGlyph* FTBufferFont::MakeGlyph(FT_GlyphSlot ftGlyph)
 {
     FTBufferFontImpl *myimpl = dynamic_cast<FTBufferFontImpl *>(impl);
@@ -72,23 +83,20 @@ FTGlyph* FTBufferFont::MakeGlyph(FT_GlyphSlot ftGlyph)
 
 FTBufferFontImpl::FTBufferFontImpl(FTFont *ftFont, const char* fontFilePath) :
     FTFontImpl(ftFont, fontFilePath),
-    buffer(new FTBuffer())
+    buffer(new FTBuffer()),
+    newestString(-1),
+    oldestString(-1),
+    freeString(-1),
+    stringCount(0),
+    byteCount(0),
+    currentPage(-1),
+    pageBudget(0),
+    renderCount(0),
+    maximumTextureSize(0)
 {
     load_flags = FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP;
 
-    glGenTextures(BUFFER_CACHE_SIZE, idCache);
-
-    for(int i = 0; i < BUFFER_CACHE_SIZE; i++)
-    {
-        stringCache[i] = NULL;
-        glBindTexture(GL_TEXTURE_2D, idCache[i]);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); //GL_CLAMP);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); //GL_CLAMP);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    }
-
-    lastString = 0;
+    CacheSize(64, 0);
 }
 
 
@@ -96,38 +104,38 @@ FTBufferFontImpl::FTBufferFontImpl(FTFont *ftFont,
                                    const unsigned char *pBufferBytes,
                                    size_t bufferSizeInBytes) :
     FTFontImpl(ftFont, pBufferBytes, bufferSizeInBytes),
-    buffer(new FTBuffer())
+    buffer(new FTBuffer()),
+    newestString(-1),
+    oldestString(-1),
+    freeString(-1),
+    stringCount(0),
+    byteCount(0),
+    currentPage(-1),
+    pageBudget(0),
+    renderCount(0),
+    maximumTextureSize(0)
 {
     load_flags = FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP;
 
-    glGenTextures(BUFFER_CACHE_SIZE, idCache);
-
-    for(int i = 0; i < BUFFER_CACHE_SIZE; i++)
-    {
-        stringCache[i] = NULL;
-        glBindTexture(GL_TEXTURE_2D, idCache[i]);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);  //GL_CLAMP);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); //GL_CLAMP);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    }
-
-    lastString = 0;
+    CacheSize(64, 0);
 }
 
 
 FTBufferFontImpl::~FTBufferFontImpl()
 {
-    glDeleteTextures(BUFFER_CACHE_SIZE, idCache);
-
-    for(int i = 0; i < BUFFER_CACHE_SIZE; i++)
+    for(size_t i = 0; i < strings.size(); i++)
     {
-        if(stringCache[i])
+        if(strings[i].text)
         {
-            free(stringCache[i]);
+            free(strings[i].text);
         }
     }
 
+    for(size_t i = 0; i < pages.size(); i++)
+    {
+        ftglesDeleteTextures(1, &pages[i].texture);
+    }
+
     delete buffer;
 }
 
@@ -138,197 +146,529 @@ FTGlyph* FTBufferFontImpl::MakeGlyphImpl(FT_GlyphSlot ftGlyph)
 }
 
 
+static inline GLuint NextPowerOf2(GLuint in)
+{
+     in -= 1;
+
+     in |= in >> 16;
+     in |= in >> 8;
+     in |= in >> 4;
+     in |= in >> 2;
+     in |= in >> 1;
+
+     return in + 1;
+}
+
+
 bool FTBufferFontImpl::FaceSize(const unsigned int size,
                                 const unsigned int res)
 {
-    for(int i = 0; i < BUFFER_CACHE_SIZE; i++)
+    ClearStrings();
+
+    return FTFontImpl::FaceSize(size, res);
+}
+
+
+void FTBufferFontImpl::CacheSize(unsigned int count, size_t bytes)
+{
+    stringLimit = count;
+    byteLimit = bytes;
+
+    // Pages are only recycled whole, so the budget may hold a little less
+    // than the byte limit in strings.
+    pageBudget = byteLimit ? byteLimit / (BUFFER_PAGE_SIZE * BUFFER_PAGE_SIZE)
+                           : 0;
+    if(byteLimit && !pageBudget)
+    {
+        pageBudget = 1;
+    }
+
+    while(oldestString >= 0 && ((stringLimit && stringCount > stringLimit)
+                                || (byteLimit && byteCount > byteLimit)))
     {
-        if(stringCache[i])
+        FreeString(oldestString);
+    }
+
+    if(pageBudget && pages.size() > pageBudget)
+    {
+        // Quads already batched still sample the pages
+        ftglesFlush();
+
+        while(pages.size() > pageBudget)
         {
-            free(stringCache[i]);
-            stringCache[i] = NULL;
+            int last = pages.size() - 1;
+
+            for(size_t i = 0; i < strings.size(); i++)
+            {
+                if(strings[i].text && strings[i].page == last)
+                {
+                    FreeString(i);
+                }
+            }
+
+            ftglesDeleteTextures(1, &pages[last].texture);
+            pages.resize(last, StringPage());
+            currentPage = currentPage == last ? -1 : currentPage;
         }
     }
 
-    return FTFontImpl::FaceSize(size, res);
+    Rehash();
 }
 
 
-static inline GLuint NextPowerOf2(GLuint in)
+void FTBufferFontImpl::Rehash()
 {
-     in -= 1;
+    size_t wanted = 64;
+    while(wanted < stringLimit * 2 || wanted < stringCount * 2)
+    {
+        wanted *= 2;
+    }
 
-     in |= in >> 16;
-     in |= in >> 8;
-     in |= in >> 4;
-     in |= in >> 2;
-     in |= in >> 1;
+    buckets.clear();
+    buckets.resize(wanted, -1);
 
-     return in + 1;
+    for(int i = newestString; i >= 0; i = strings[i].older)
+    {
+        int bucket = strings[i].hash & (buckets.size() - 1);
+        strings[i].chain = buckets[bucket];
+        buckets[bucket] = i;
+    }
 }
 
 
-inline int StringCompare(void const *a, char const *b, int len)
+void FTBufferFontImpl::Unlink(int index)
 {
-    return len < 0 ? strcmp((char const *)a, b)
-                   : strncmp((char const *)a, b, len);
+    CachedString& entry = strings[index];
+
+    if(entry.newer >= 0)
+    {
+        strings[entry.newer].older = entry.older;
+    }
+    else
+    {
+        newestString = entry.older;
+    }
+
+    if(entry.older >= 0)
+    {
+        strings[entry.older].newer = entry.newer;
+    }
+    else
+    {
+        oldestString = entry.newer;
+    }
 }
 
 
-inline int StringCompare(void const *a, wchar_t const *b, int len)
+void FTBufferFontImpl::LinkNewest(int index)
 {
-    return len < 0 ? wcscmp((wchar_t const *)a, b)
-                   : wcsncmp((wchar_t const *)a, b, len);
+    CachedString& entry = strings[index];
+
+    entry.newer = -1;
+    entry.older = newestString;
+
+    if(newestString >= 0)
+    {
+        strings[newestString].newer = index;
+    }
+    else
+    {
+        oldestString = index;
+    }
+
+    newestString = index;
 }
 
 
-inline char *StringCopy(char const *s, int len)
+void FTBufferFontImpl::FreeString(int index)
 {
-    if(len < 0)
+    CachedString& entry = strings[index];
+
+    int* link = &buckets[entry.hash & (buckets.size() - 1)];
+    while(*link != index)
     {
-        return strdup(s);
+        link = &strings[*link].chain;
     }
-    else
+    *link = entry.chain;
+
+    Unlink(index);
+
+    if(entry.page >= 0)
     {
-#ifdef HAVE_STRNDUP
-        return strndup(s, len);
-#else
-        char *s2 = (char*)malloc(len + 1);
-        memcpy(s2, s, len);
-        s2[len] = 0;
-        return s2;
-#endif
+        pages[entry.page].strings--;
     }
+
+    free(entry.text);
+    entry.text = NULL;
+    entry.chain = freeString;
+    freeString = index;
+
+    stringCount--;
+    byteCount -= entry.bytes;
+
+    // Recorded text may still point at the old texture.
+    generation++;
 }
 
 
-inline wchar_t *StringCopy(wchar_t const *s, int len)
+int FTBufferFontImpl::NewString(size_t bytes)
 {
-    if(len < 0)
+    while(oldestString >= 0 && ((stringLimit && stringCount >= stringLimit)
+                                || (byteLimit && byteCount + bytes > byteLimit)))
+    {
+        FreeString(oldestString);
+    }
+
+    int index = freeString;
+    if(index >= 0)
+    {
+        freeString = strings[index].chain;
+    }
+    else
     {
-#if defined HAVE_WCSDUP
-        return wcsdup(s);
-#else
-        len = (int)wcslen(s);
-#endif
+        CachedString entry;
+        entry.text = NULL;
+        index = (int)strings.size();
+        strings.push_back(entry);
     }
 
-    wchar_t *s2 = (wchar_t *)malloc((len + 1) * sizeof(wchar_t));
-    memcpy(s2, s, len * sizeof(wchar_t));
-    s2[len] = 0;
-    return s2;
+    stringCount++;
+    byteCount += bytes;
+    strings[index].bytes = bytes;
+    strings[index].page = -1;
+
+    if(stringCount * 2 > buckets.size())
+    {
+        Rehash();
+    }
+
+    return index;
 }
 
 
-template <typename T>
-inline FTPoint FTBufferFontImpl::RenderI(const T* string, const int len,
-                                         FTPoint position, FTPoint spacing,
-                                         int renderMode)
+void FTBufferFontImpl::ClearStrings()
 {
-    const float padding = 3.0f;
-    int width, height, texWidth, texHeight;
-    int cacheIndex = -1;
-    bool inCache = false;
+    while(oldestString >= 0)
+    {
+        FreeString(oldestString);
+    }
+}
 
-    // Protect blending functions, GL_BLEND and GL_TEXTURE_2D
-   // glPushAttrib(GL_COLOR_BUFFER_BIT | GL_ENABLE_BIT);
 
-    // Protect glPixelStorei() calls
-   // glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+void FTBufferFontImpl::PlaceString(int index)
+{
+    int width = strings[index].width;
+    int height = strings[index].height;
+    int x, y;
 
-    glEnable(GL_BLEND);
-    glEnable(GL_TEXTURE_2D);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // GL_ONE
+    if(!maximumTextureSize)
+    {
+        maximumTextureSize = ftglesMaxTextureSize();
+        if(maximumTextureSize <= 0)
+        {
+            maximumTextureSize = 1024;
+        }
+    }
 
-    // Search whether the string is already in a texture we uploaded
-    for(int n = 0; n < BUFFER_CACHE_SIZE; n++)
+    if(currentPage < 0 || width > pages[currentPage].width
+       || height > pages[currentPage].height
+       || !packer.Insert(width, height, x, y))
     {
-        int i = (lastString + n + BUFFER_CACHE_SIZE) % BUFFER_CACHE_SIZE;
+        int pageWidth = NextPowerOf2(width);
+        int pageHeight = NextPowerOf2(height);
+        pageWidth = pageWidth < BUFFER_PAGE_SIZE ? BUFFER_PAGE_SIZE : pageWidth;
+        pageHeight = pageHeight < BUFFER_PAGE_SIZE ? BUFFER_PAGE_SIZE
+                                                   : pageHeight;
+        pageWidth = pageWidth > maximumTextureSize ? maximumTextureSize
+                                                   : pageWidth;
+        pageHeight = pageHeight > maximumTextureSize ? maximumTextureSize
+                                                     : pageHeight;
+
+        // A page with no strings left, a new one, or the least recently
+        // drawn one emptied
+        int page = -1;
+        for(size_t i = 0; i < pages.size() && page < 0; i++)
+        {
+            if(!pages[i].strings)
+            {
+                page = i;
+            }
+        }
+
+        if(page < 0 && pageBudget && pages.size() >= pageBudget)
+        {
+            page = 0;
+            for(size_t i = 1; i < pages.size(); i++)
+            {
+                if(pages[i].lastUsed < pages[page].lastUsed)
+                {
+                    page = i;
+                }
+            }
+
+            for(size_t i = 0; i < strings.size(); i++)
+            {
+                if(strings[i].text && strings[i].page == page)
+                {
+                    FreeString(i);
+                }
+            }
+        }
 
-        if(stringCache[i] && !StringCompare(stringCache[i], string, len))
+        if(page < 0)
         {
-            cacheIndex = i;
-            inCache = true;
-            break;
+            StringPage newPage;
+            newPage.texture = ftglesCreateTexture();
+            newPage.width = newPage.height = 0;
+            newPage.strings = 0;
+            page = pages.size();
+            pages.push_back(newPage);
         }
+        else
+        {
+            // Quads already batched still sample the old strings
+            ftglesFlush();
+        }
+
+        StringPage& reused = pages[page];
+        if(reused.width < pageWidth || reused.height < pageHeight)
+        {
+            reused.width = reused.width > pageWidth ? reused.width : pageWidth;
+            reused.height = reused.height > pageHeight ? reused.height
+                                                       : pageHeight;
+
+            unsigned char* blank =
+                new unsigned char[reused.width * reused.height];
+            memset(blank, 0, reused.width * reused.height);
+            ftglesTextureImage(reused.texture, reused.width, reused.height,
+                               blank);
+            delete[] blank;
+        }
+
+        currentPage = page;
+        packer.Reset(reused.width, reused.height);
+        packer.Insert(width, height, x, y);
     }
 
-    // If the string was not found, we need to put it in the cache and compute
-    // its new bounding box.
-    if(!inCache)
+    pages[currentPage].strings++;
+    strings[index].page = currentPage;
+    strings[index].x = x;
+    strings[index].y = y;
+}
+
+
+/**
+ * Strings are hashed and compared by their UTF-8 bytes or wide characters.
+ */
+template <typename T> struct FTStringUnit;
+
+template <> struct FTStringUnit<char>
+{
+    typedef unsigned char type;
+    static const type* Of(const char* s) { return (const type*)s; }
+};
+
+template <> struct FTStringUnit<wchar_t>
+{
+    typedef wchar_t type;
+    static const type* Of(const wchar_t* s) { return s; }
+};
+
+
+/**
+ * The number of units of s its first len characters take up, or all of
+ * them if len is negative.
+ */
+template <typename T>
+static inline int StringUnits(const T* s, int len)
+{
+    if(len < 0)
     {
-        // FIXME: this cache is not very efficient. We should first expire
-        // strings that are not used very often.
-        cacheIndex = lastString;
-        lastString = (lastString + 1) % BUFFER_CACHE_SIZE;
+        int n = 0;
+        while(s[n])
+        {
+            n++;
+        }
+        return n;
+    }
 
-        if(stringCache[cacheIndex])
+    FTUnicodeStringItr<T> ustr(s);
+    for(int i = 0; i < len; i++)
+    {
+        ++ustr;
+    }
+    return (int)(ustr.getBufferFromHere() - s);
+}
+
+
+template <typename T>
+static inline unsigned int StringHash(const T* s, int units)
+{
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for(int i = 0; i < units; i++)
+    {
+        hash = (hash ^ (unsigned int)s[i]) * 16777619u;
+    }
+    return hash;
+}
+
+
+template <typename T>
+int FTBufferFontImpl::FindString(const T* s, int units, unsigned int hash,
+                                 FTPoint spacing, int mode) const
+{
+    int i = buckets[hash & (buckets.size() - 1)];
+
+    while(i >= 0)
+    {
+        const CachedString& entry = strings[i];
+
+        if(entry.hash == hash && entry.length == units
+            && entry.charSize == (int)sizeof(T) && entry.mode == mode
+            && entry.spacing == spacing
+            && !memcmp(entry.text, s, units * sizeof(T)))
         {
-            free(stringCache[cacheIndex]);
+            return i;
         }
-        // FIXME: only the first N bytes are copied; we want the first N chars.
-        stringCache[cacheIndex] = StringCopy(string, len);
-        bboxCache[cacheIndex] = BBox(string, len, FTPoint(), spacing);
+
+        i = entry.chain;
     }
 
-    FTBBox bbox = bboxCache[cacheIndex];
+    return -1;
+}
+
 
-    width = static_cast<int>(bbox.Upper().X() - bbox.Lower().X()
-                              + padding + padding + 0.5);
-    height = static_cast<int>(bbox.Upper().Y() - bbox.Lower().Y()
-                               + padding + padding + 0.5);
+template <typename T>
+inline FTPoint FTBufferFontImpl::RenderI(const T* string, const int len,
+                                         FTPoint position, FTPoint spacing,
+                                         int renderMode)
+{
+    const float padding = 3.0f;
+    int width, height;
+    bool batched = ftglesInSession() || ftglesInCapture();
+    ftglesTextState_t textState;
 
-    texWidth = NextPowerOf2(width);
-    texHeight = NextPowerOf2(height);
+    // Protect blending functions, GL_BLEND and GL_TEXTURE_2D
+    if(!batched)
+    {
+        ftglesSaveTextState(&textState);
+    }
 
-    glBindTexture(GL_TEXTURE_2D, idCache[cacheIndex]);
+    // Search whether the string is already in a texture we uploaded
+    const typename FTStringUnit<T>::type* ustring = FTStringUnit<T>::Of(string);
+    int units = StringUnits(ustring, len);
+    unsigned int hash = StringHash(ustring, units);
+    int cacheIndex = FindString(ustring, units, hash, spacing, renderMode);
 
-    // If the string was not found, we need to render the text in a new
-    // texture buffer, then upload it to the OpenGL layer.
-    if(!inCache)
+    if(cacheIndex >= 0)
+    {
+        Unlink(cacheIndex);
+        LinkNewest(cacheIndex);
+    }
+    else
     {
-        buffer->Size(texWidth, texHeight);
+        // If the string was not found, render it and pack it into a
+        // texture page, evicting the least recently rendered strings to
+        // make room.
+        if(!maximumTextureSize)
+        {
+            maximumTextureSize = ftglesMaxTextureSize();
+            if(maximumTextureSize <= 0)
+            {
+                maximumTextureSize = 1024;
+            }
+        }
+
+        FTBBox bbox = BBox(string, len, FTPoint(), spacing);
+
+        // A string larger than a texture is cut down to what fits
+        width = static_cast<int>(bbox.Upper().X() - bbox.Lower().X()
+                                  + padding + padding + 0.5);
+        height = static_cast<int>(bbox.Upper().Y() - bbox.Lower().Y()
+                                   + padding + padding + 0.5);
+        width = width > maximumTextureSize ? maximumTextureSize : width;
+        height = height > maximumTextureSize ? maximumTextureSize : height;
+
+        size_t textBytes = (units + 1) * sizeof(T);
+        cacheIndex = NewString(width * height + textBytes);
+
+        CachedString& entry = strings[cacheIndex];
+        entry.text = malloc(textBytes);
+        memcpy(entry.text, string, units * sizeof(T));
+        memset((char*)entry.text + units * sizeof(T), 0, sizeof(T));
+        entry.hash = hash;
+        entry.length = units;
+        entry.charSize = sizeof(T);
+        entry.spacing = spacing;
+        entry.mode = renderMode;
+        entry.bbox = bbox;
+        entry.width = width;
+        entry.height = height;
+
+        PlaceString(cacheIndex);
+
+        int bucket = hash & (buckets.size() - 1);
+        entry.chain = buckets[bucket];
+        buckets[bucket] = cacheIndex;
+        LinkNewest(cacheIndex);
+
+        buffer->Size(width, height);
         buffer->Pos(FTPoint(padding, padding) - bbox.Lower());
 
-        advanceCache[cacheIndex] =
+        // The string is one alpha texture, so colour runs cannot apply
+        const FTGL::FTGLcolorrun* runs = colorRuns;
+        colorRuns = 0;
+        entry.advance =
               FTFontImpl::Render(string, len, FTPoint(), spacing, renderMode);
+        colorRuns = runs;
 
-        glBindTexture(GL_TEXTURE_2D, idCache[cacheIndex]);
-
-        //glPixelStorei(GL_UNPACK_LSB_FIRST, GL_FALSE);
-        //glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-        /* TODO: use glTexSubImage2D later? */
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, texWidth, texHeight, 0,
-                     GL_ALPHA, GL_UNSIGNED_BYTE, (GLvoid *)buffer->Pixels());
+        ftglesTextureSubImage(pages[entry.page].texture, entry.x, entry.y,
+                              width, height, (GLvoid *)buffer->Pixels());
 
         buffer->Size(0, 0);
     }
 
-    FTPoint low = position + bbox.Lower();
-    FTPoint up = position + bbox.Upper();
+    const CachedString& entry = strings[cacheIndex];
+    StringPage& page = pages[entry.page];
+    page.lastUsed = ++renderCount;
+
+    float pageWidth = static_cast<float>(page.width);
+    float pageHeight = static_cast<float>(page.height);
+    float left = (entry.x + padding) / pageWidth;
+    float top = (entry.y + padding) / pageHeight;
+    float right = (entry.x + entry.width - padding) / pageWidth;
+    float bottom = (entry.y + entry.height - padding) / pageHeight;
+
+    FTPoint low = position + entry.bbox.Lower();
+    FTPoint up = position + entry.bbox.Upper();
+    if(up.X() - low.X() > entry.width - padding - padding)
+    {
+        up.X(low.X() + entry.width - padding - padding);
+    }
+    if(up.Y() - low.Y() > entry.height - padding - padding)
+    {
+        up.Y(low.Y() + entry.height - padding - padding);
+    }
 
     ftglBegin(GL_QUADS);
-        glNormal3f(0.0f, 0.0f, 1.0f);
-        ftglTexCoord2f(padding / texWidth,
-                     (texHeight - height + padding) / texHeight);
+        ftglBindTexture(page.texture);
+        ftglTexCoord2f(left, top);
         ftglVertex2f(low.Xf(), up.Yf());
-        ftglTexCoord2f(padding / texWidth,
-                     (texHeight - padding) / texHeight);
+        ftglTexCoord2f(left, bottom);
         ftglVertex2f(low.Xf(), low.Yf());
-        ftglTexCoord2f((width - padding) / texWidth,
-                     (texHeight - padding) / texHeight);
+        ftglTexCoord2f(right, bottom);
         ftglVertex2f(up.Xf(), low.Yf());
-        ftglTexCoord2f((width - padding) / texWidth,
-                     (texHeight - height + padding) / texHeight);
+        ftglTexCoord2f(right, top);
         ftglVertex2f(up.Xf(), up.Yf());
     ftglEnd();
 
-    //glPopClientAttrib();
-   // glPopAttrib();
+    if(!batched)
+    {
+        ftglesRestoreTextState(&textState);
+    }
 
-    return position + advanceCache[cacheIndex];
+    return position + entry.advance;
 }
 
 
@@ -28,6 +28,9 @@
 
 #include "FTFontImpl.h"
 
+#include "FTVector.h"
+#include "FTSkyline.h"
+
 class FTGlyph;
 class FTBuffer;
 
@@ -51,9 +54,17 @@ class FTBufferFontImpl : public FTFontImpl
                                FTPoint position, FTPoint spacing,
                                int renderMode);
 
+        virtual bool RendersQuads() const { return true; }
+
         virtual bool FaceSize(const unsigned int size,
                               const unsigned int res);
 
+        /**
+         * Set the most strings to keep textures for, and the most bytes
+         * of texture and string copies between them, or 0 for no limit.
+         */
+        void CacheSize(unsigned int strings, size_t bytes);
+
     private:
         /**
          * Create an FTBufferGlyph object for the base class.
@@ -68,13 +79,90 @@ class FTBufferFontImpl : public FTFontImpl
         /* Pixel buffer */
         FTBuffer *buffer;
 
-        static const int BUFFER_CACHE_SIZE = 64;
-        /* Texture IDs */
-        GLuint idCache[BUFFER_CACHE_SIZE];
-        void *stringCache[BUFFER_CACHE_SIZE];
-        FTBBox bboxCache[BUFFER_CACHE_SIZE];
-        FTPoint advanceCache[BUFFER_CACHE_SIZE];
-        int lastString;
+        /**
+         * A rendered string. Entries are chained from the hash buckets and
+         * linked from the most to the least recently rendered; free ones
+         * are chained from freeString. Its bitmap, padding included, is
+         * at x, y in a texture page.
+         */
+        struct CachedString
+        {
+            void *text;
+            unsigned int hash;
+            int length;
+            int charSize;
+            FTPoint spacing;
+            int mode;
+            int page;
+            int x, y, width, height;
+            size_t bytes;
+            FTBBox bbox;
+            FTPoint advance;
+            int chain;
+            int newer, older;
+        };
+
+        FTVector<CachedString> strings;
+        FTVector<int> buckets;
+        int newestString, oldestString, freeString;
+        unsigned int stringCount, stringLimit;
+        size_t byteCount, byteLimit;
+
+        /**
+         * Find a string in the cache, or -1.
+         */
+        template <typename T>
+        int FindString(const T *s, int length, unsigned int hash,
+                       FTPoint spacing, int mode) const;
+
+        /**
+         * Take a free entry for a new string, evicting the least recently
+         * rendered ones to stay within the limits.
+         */
+        int NewString(size_t bytes);
+
+        void FreeString(int index);
+
+        void Unlink(int index);
+
+        void LinkNewest(int index);
+
+        /**
+         * The textures string bitmaps are packed into, and how many
+         * cached strings each holds. Strings are packed into the current
+         * page until it is full, then into a page with none left, a new
+         * page, or the least recently drawn page once the budget is
+         * reached, whose strings are dropped.
+         */
+        struct StringPage
+        {
+            GLuint texture;
+            int width, height;
+            unsigned int strings;
+            unsigned int lastUsed;
+        };
+
+        static const int BUFFER_PAGE_SIZE = 512;
+
+        FTVector<StringPage> pages;
+        int currentPage;
+        FTSkyline packer;
+        unsigned int pageBudget;
+        unsigned int renderCount;
+        GLsizei maximumTextureSize;
+
+        /**
+         * Find room for a string bitmap, setting its page and position.
+         */
+        void PlaceString(int index);
+
+        /**
+         * Size the buckets to the string limit and chain every entry
+         * again.
+         */
+        void Rehash();
+
+        void ClearStrings();
 };
 
 #endif  //  __FTBufferFontImpl__
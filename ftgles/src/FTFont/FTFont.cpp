@@ -95,6 +95,12 @@ unsigned int FTFont::FaceSize() const
 }
 
 
+void FTFont::CachedSizes(unsigned int count)
+{
+    return impl->CachedSizes(count);
+}
+
+
 void FTFont::Depth(float depth)
 {
     return impl->Depth(depth);
@@ -175,6 +181,39 @@ FTPoint FTFont::Render(const wchar_t * string, const int len,
 }
 
 
+FTPoint FTFont::Render(const char * string, FTQuadSink& sink, const int len,
+                       FTPoint position, FTPoint spacing)
+{
+    return impl->RenderSinkI(string, sink, len, position, spacing);
+}
+
+
+FTPoint FTFont::Render(const wchar_t * string, FTQuadSink& sink,
+                       const int len, FTPoint position, FTPoint spacing)
+{
+    return impl->RenderSinkI(string, sink, len, position, spacing);
+}
+
+
+FTPoint FTFont::Render(const char * string, const FTGL::FTGLcolorrun* runs,
+                       unsigned int runCount, const int len,
+                       FTPoint position, FTPoint spacing, int renderMode)
+{
+    return impl->RenderRunsI(string, runs, runCount, len, position, spacing,
+                             renderMode);
+}
+
+
+FTPoint FTFont::Render(const wchar_t * string,
+                       const FTGL::FTGLcolorrun* runs, unsigned int runCount,
+                       const int len, FTPoint position, FTPoint spacing,
+                       int renderMode)
+{
+    return impl->RenderRunsI(string, runs, runCount, len, position, spacing,
+                             renderMode);
+}
+
+
 
 void FTFont::PreRender() { impl->PreRender(); }
 
@@ -195,6 +234,24 @@ float FTFont::Advance(const wchar_t * string, const int len, FTPoint spacing)
 }
 
 
+unsigned int FTFont::Preload(const char * string)
+{
+    return impl->Preload(string, -1);
+}
+
+
+unsigned int FTFont::Preload(const wchar_t * string)
+{
+    return impl->Preload(string, -1);
+}
+
+
+unsigned int FTFont::Preload(unsigned int first, unsigned int last)
+{
+    return impl->Preload(first, last);
+}
+
+
 FTBBox FTFont::BBox(const char *string, const int len,
                     FTPoint position, FTPoint spacing)
 {
@@ -224,8 +281,15 @@ FTFontImpl::FTFontImpl(FTFont *ftFont, char const *fontFilePath) :
     face(fontFilePath),
     useDisplayLists(true),
     load_flags(FT_LOAD_DEFAULT),
+    generation(0),
+    glyphIndex(0),
+    charCode(0),
+    colorRuns(0),
+    colorRunCount(0),
     intf(ftFont),
-    glyphList(0)
+    glyphList(0),
+    sizeLimit(4),
+    sizeClock(0)
 {
     err = face.Error();
     if(err == 0)
@@ -240,8 +304,15 @@ FTFontImpl::FTFontImpl(FTFont *ftFont, const unsigned char *pBufferBytes,
     face(pBufferBytes, bufferSizeInBytes),
     useDisplayLists(true),
     load_flags(FT_LOAD_DEFAULT),
+    generation(0),
+    glyphIndex(0),
+    charCode(0),
+    colorRuns(0),
+    colorRunCount(0),
     intf(ftFont),
-    glyphList(0)
+    glyphList(0),
+    sizeLimit(4),
+    sizeClock(0)
 {
     err = face.Error();
     if(err == 0)
@@ -253,10 +324,16 @@ FTFontImpl::FTFontImpl(FTFont *ftFont, const unsigned char *pBufferBytes,
 
 FTFontImpl::~FTFontImpl()
 {
-    if(glyphList)
+    // The current glyphs are in the cache once a size is set
+    if(glyphList && FindSize(glyphList) < 0)
     {
         delete glyphList;
     }
+
+    for(unsigned int i = 0; i < sizeCache.size(); ++i)
+    {
+        delete sizeCache[i].glyphList;
+    }
 }
 
 
@@ -289,11 +366,14 @@ bool FTFontImpl::Attach(const unsigned char *pBufferBytes,
 
 bool FTFontImpl::FaceSize(const unsigned int size, const unsigned int res)
 {
-    if(glyphList != NULL)
+    generation++;
+
+    // The glyphs made before any size was set are not kept
+    if(glyphList != NULL && FindSize(glyphList) < 0)
     {
         delete glyphList;
-        glyphList = NULL;
     }
+    glyphList = NULL;
 
     charSize = face.Size(size, res);
     err = face.Error();
@@ -303,11 +383,114 @@ bool FTFontImpl::FaceSize(const unsigned int size, const unsigned int res)
         return false;
     }
 
+    for(unsigned int i = 0; i < sizeCache.size(); ++i)
+    {
+        if(sizeCache[i].size == size && sizeCache[i].res == res)
+        {
+            sizeCache[i].lastUsed = ++sizeClock;
+            glyphList = sizeCache[i].glyphList;
+            return true;
+        }
+    }
+
     glyphList = new FTGlyphContainer(&face);
+
+    CachedSize cached;
+    cached.size = size;
+    cached.res = res;
+    cached.charSize = charSize;
+    cached.glyphList = glyphList;
+    cached.lastUsed = ++sizeClock;
+    sizeCache.push_back(cached);
+
+    TrimSizes(sizeLimit);
     return true;
 }
 
 
+void FTFontImpl::CachedSizes(unsigned int count)
+{
+    sizeLimit = count < 1 ? 1 : count;
+    TrimSizes(sizeLimit);
+}
+
+
+void FTFontImpl::TrimSizes(unsigned int count)
+{
+    while(sizeCache.size() > count)
+    {
+        int oldest = -1;
+
+        for(unsigned int i = 0; i < sizeCache.size(); ++i)
+        {
+            if(sizeCache[i].glyphList != glyphList
+               && (oldest < 0
+                   || sizeCache[i].lastUsed < sizeCache[oldest].lastUsed))
+            {
+                oldest = i;
+            }
+        }
+
+        if(oldest < 0)
+        {
+            return;
+        }
+
+        DropSize(oldest);
+    }
+}
+
+
+void FTFontImpl::DropSize(unsigned int index)
+{
+    CachedSize cached = sizeCache[index];
+
+    sizeCache[index] = sizeCache[sizeCache.size() - 1];
+    sizeCache.resize(sizeCache.size() - 1, CachedSize());
+
+    ReleaseSize(cached.charSize, cached.glyphList);
+
+    delete cached.glyphList;
+    face.ReleaseSize(cached.size, cached.res);
+    generation++;
+}
+
+
+void FTFontImpl::DropSizes()
+{
+    if(glyphList && FindSize(glyphList) < 0)
+    {
+        delete glyphList;
+    }
+
+    for(unsigned int i = 0; i < sizeCache.size(); ++i)
+    {
+        ReleaseSize(sizeCache[i].charSize, sizeCache[i].glyphList);
+        delete sizeCache[i].glyphList;
+        face.ReleaseSize(sizeCache[i].size, sizeCache[i].res);
+    }
+    sizeCache.resize(0, CachedSize());
+
+    glyphList = new FTGlyphContainer(&face);
+    charSize = FTSize();
+    generation++;
+}
+
+
+int FTFontImpl::FindSize(const FTGlyphContainer* glyphs) const
+{
+    for(unsigned int i = 0; i < sizeCache.size(); ++i)
+    {
+        if(sizeCache[i].glyphList == glyphs)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
 unsigned int FTFontImpl::FaceSize() const
 {
     return charSize.CharSize();
@@ -342,6 +525,9 @@ bool FTFontImpl::CharMap(FT_Encoding encoding)
 {
     bool result = glyphList->CharMap(encoding);
     err = glyphList->Error();
+
+    // Other sizes' glyphs were looked up through the old map
+    TrimSizes(1);
     return result;
 }
 
@@ -483,6 +669,67 @@ float FTFontImpl::Advance(const wchar_t* string, const int len, FTPoint spacing)
 }
 
 
+template <typename T>
+inline unsigned int FTFontImpl::PreloadI(const T* string, const int len)
+{
+    unsigned int made = 0;
+    FTUnicodeStringItr<T> ustr(string);
+
+    for(int i = 0; (len < 0 && *ustr) || (len >= 0 && i < len); i++)
+    {
+        unsigned int thisChar = *ustr++;
+
+        if(!glyphList->Glyph(thisChar) && CheckGlyph(thisChar))
+        {
+            made++;
+        }
+    }
+
+    return made;
+}
+
+
+unsigned int FTFontImpl::Preload(const char* string, const int len)
+{
+    /* The chars need to be unsigned because they are cast to int later */
+    return PreloadI((const unsigned char *)string, len);
+}
+
+
+unsigned int FTFontImpl::Preload(const wchar_t* string, const int len)
+{
+    return PreloadI(string, len);
+}
+
+
+unsigned int FTFontImpl::Preload(unsigned int first, unsigned int last)
+{
+    unsigned int made = 0;
+
+    if(first > last)
+    {
+        return made;
+    }
+
+    // Stops after last without stepping past it, so a range ending at
+    // UINT_MAX does not wrap.
+    unsigned int c = first;
+    do
+    {
+        // Only characters the face maps; the rest would all make the
+        // missing glyph.
+        if(!glyphList->Glyph(c) && glyphList->FontIndex(c)
+           && CheckGlyph(c))
+        {
+            made++;
+        }
+    }
+    while(c++ != last);
+
+    return made;
+}
+
+
 template <typename T>
 inline FTPoint FTFontImpl::RenderI(const T* string, const int len,
                                    FTPoint position, FTPoint spacing,
@@ -490,15 +737,22 @@ inline FTPoint FTFontImpl::RenderI(const T* string, const int len,
 {
     // for multibyte - we can't rely on sizeof(T) == character
     FTUnicodeStringItr<T> ustr(string);
+    unsigned int run = 0;
 
     for(int i = 0; (len < 0 && *ustr) || (len >= 0 && i < len); i++)
     {
         unsigned int thisChar = *ustr++;
         unsigned int nextChar = *ustr;
 
+        // Switch colour at run boundaries; the glue keeps it per vertex
+        while(run < colorRunCount && colorRuns[run].start <= (unsigned int)i)
+        {
+            const unsigned char *rgba = colorRuns[run++].rgba;
+            ftglColor4ub(rgba[0], rgba[1], rgba[2], rgba[3]);
+        }
+
         if(CheckGlyph(thisChar))
         {
-			
             position += glyphList->Render(thisChar, nextChar,
                                           position, renderMode);
         }
@@ -513,6 +767,96 @@ inline FTPoint FTFontImpl::RenderI(const T* string, const int len,
 }
 
 
+/*
+ * Hands a batch of captured glue quads to an FTQuadSink.
+ */
+static GLvoid EmitQuads(void *data, const ftglesVertex_t *vertices,
+                        const GLuint *textures, unsigned int count)
+{
+    FTQuadSink *sink = static_cast<FTQuadSink*>(data);
+    FTGL::FTGLquad quads[64];
+    unsigned int n = 0;
+
+    for(unsigned int i = 0; i < count; i += 4)
+    {
+        const ftglesVertex_t *v = vertices + i;
+        FTGL::FTGLquad &quad = quads[n++];
+
+        quad.x0 = v[0].xyz[0];
+        quad.y0 = v[0].xyz[1];
+        quad.s0 = v[0].st[0];
+        quad.t0 = v[0].st[1];
+        quad.x1 = v[2].xyz[0];
+        quad.y1 = v[2].xyz[1];
+        quad.s1 = v[2].st[0];
+        quad.t1 = v[2].st[1];
+        memcpy(quad.rgba, v[0].rgba, 4);
+        quad.page = textures[i / 4];
+
+        if(n == 64)
+        {
+            sink->Quads(quads, n);
+            n = 0;
+        }
+    }
+
+    if(n)
+    {
+        sink->Quads(quads, n);
+    }
+}
+
+
+template <typename T>
+inline FTPoint FTFontImpl::RenderSinkI(const T* string, FTQuadSink& sink,
+                                       const int len, FTPoint position,
+                                       FTPoint spacing)
+{
+    // Lines and triangles would still reach the backend
+    if(!RendersQuads())
+    {
+        return position;
+    }
+
+    ftglesCapture_t capture;
+    memset(&capture, 0, sizeof(capture));
+    capture.emit = EmitQuads;
+    capture.userData = &sink;
+
+    ftglesBeginCapture(&capture);
+    position = Render(string, len, position, spacing, FTGL::RENDER_ALL);
+    ftglesEndCapture();
+
+    return position;
+}
+
+
+template <typename T>
+inline FTPoint FTFontImpl::RenderRunsI(const T* string,
+                                       const FTGL::FTGLcolorrun* runs,
+                                       unsigned int runCount, const int len,
+                                       FTPoint position, FTPoint spacing,
+                                       int renderMode)
+{
+    const FTGL::FTGLcolorrun* oldRuns = colorRuns;
+    unsigned int oldCount = colorRunCount;
+    GLubyte rgba[4];
+
+    // Leave the batch colour as it was, for text drawn after us in a session
+    ftglesGetColor(rgba);
+    colorRuns = runs;
+    colorRunCount = runs ? runCount : 0;
+
+    position = Render(string, len, position, spacing, renderMode);
+
+    colorRuns = oldRuns;
+    colorRunCount = oldCount;
+    ftglColor4ub(rgba[0], rgba[1], rgba[2], rgba[3]);
+
+    return position;
+}
+
+
 FTPoint FTFontImpl::Render(const char * string, const int len,
                            FTPoint position, FTPoint spacing, int renderMode)
 {
@@ -528,6 +872,44 @@ FTPoint FTFontImpl::Render(const wchar_t * string, const int len,
 }
 
 
+void FTFontImpl::RemoveGlyph(const FTGlyph* glyph,
+                             unsigned int characterCode)
+{
+    if(glyphList)
+    {
+        glyphList->Remove(glyph, characterCode);
+    }
+
+    for(unsigned int i = 0; i < sizeCache.size(); ++i)
+    {
+        if(sizeCache[i].glyphList != glyphList)
+        {
+            sizeCache[i].glyphList->Remove(glyph, characterCode);
+        }
+    }
+}
+
+
+FTGlyph* FTFontImpl::LoadedGlyph(unsigned int characterCode) const
+{
+    if(!glyphList)
+    {
+        return NULL;
+    }
+
+    return const_cast<FTGlyph*>(glyphList->Glyph(characterCode));
+}
+
+
+void FTFontImpl::AddGlyph(FTGlyph* glyph, unsigned int characterCode)
+{
+    if(glyphList)
+    {
+        glyphList->Add(glyph, characterCode);
+    }
+}
+
+
 bool FTFontImpl::CheckGlyph(const unsigned int characterCode)
 {
     if(glyphList->Glyph(characterCode))
@@ -535,7 +917,8 @@ bool FTFontImpl::CheckGlyph(const unsigned int characterCode)
         return true;
     }
 
-    unsigned int glyphIndex = glyphList->FontIndex(characterCode);
+    glyphIndex = glyphList->FontIndex(characterCode);
+    charCode = characterCode;
     FT_GlyphSlot ftSlot = face.Glyph(glyphIndex, load_flags);
     if(!ftSlot)
     {
@@ -77,6 +77,81 @@ C_TOR(ftglCreatePolygonFont, (const char *fontname),
 C_TOR(ftglCreateTextureFont, (const char *fontname),
       FTTextureFont, (fontname), FONT_TEXTURE);
 
+// void FTBufferFont::CacheSize(unsigned int strings, size_t bytes);
+void ftglSetBufferFontCache(FTGLfont *f, unsigned int strings, size_t bytes)
+{
+    FTBufferFont *font = f ? dynamic_cast<FTBufferFont *>(f->ptr) : NULL;
+
+    if(!font)
+    {
+        fprintf(stderr, "FTGL warning: not a buffer font in %s\n",
+                __FUNCTION__);
+        return;
+    }
+
+    font->CacheSize(strings, bytes);
+}
+
+// void FTTextureFont::DistanceField(unsigned int referenceSize);
+void ftglSetFontDistanceField(FTGLfont *f, unsigned int referenceSize)
+{
+    FTTextureFont *font = f ? dynamic_cast<FTTextureFont *>(f->ptr) : NULL;
+
+    if(!font)
+    {
+        fprintf(stderr, "FTGL warning: not a texture font in %s\n",
+                __FUNCTION__);
+        return;
+    }
+
+    font->DistanceField(referenceSize);
+}
+
+// void FTTextureFont::SubpixelPositions(unsigned int phases);
+void ftglSetFontSubpixelPositions(FTGLfont *f, unsigned int phases)
+{
+    FTTextureFont *font = f ? dynamic_cast<FTTextureFont *>(f->ptr) : NULL;
+
+    if(!font)
+    {
+        fprintf(stderr, "FTGL warning: not a texture font in %s\n",
+                __FUNCTION__);
+        return;
+    }
+
+    font->SubpixelPositions(phases);
+}
+
+// bool FTTextureFont::SaveCache(const char* path);
+int ftglSaveFontCache(FTGLfont *f, const char* path)
+{
+    FTTextureFont *font = f ? dynamic_cast<FTTextureFont *>(f->ptr) : NULL;
+
+    if(!font)
+    {
+        fprintf(stderr, "FTGL warning: not a texture font in %s\n",
+                __FUNCTION__);
+        return 0;
+    }
+
+    return font->SaveCache(path) ? 1 : 0;
+}
+
+// bool FTTextureFont::LoadCache(const char* path);
+int ftglLoadFontCache(FTGLfont *f, const char* path)
+{
+    FTTextureFont *font = f ? dynamic_cast<FTTextureFont *>(f->ptr) : NULL;
+
+    if(!font)
+    {
+        fprintf(stderr, "FTGL warning: not a texture font in %s\n",
+                __FUNCTION__);
+        return 0;
+    }
+
+    return font->LoadCache(path) ? 1 : 0;
+}
+
 // FTCustomFont::FTCustomFont();
 class FTCustomFont : public FTFont
 {
@@ -169,6 +244,10 @@ C_FUN(int, ftglSetFontFaceSize, (FTGLfont *f, unsigned int s, unsigned int r),
 C_FUN(unsigned int, ftglGetFontFaceSize, (FTGLfont *f),
       return 0, FTFont::FaceSize, ());
 
+// virtual void FTFont::CachedSizes(unsigned int count);
+C_FUN(void, ftglSetFontCachedSizes, (FTGLfont *f, unsigned int c),
+      return, CachedSizes, (c));
+
 // virtual void FTFont::Depth(float depth);
 C_FUN(void, ftglSetFontDepth, (FTGLfont *f, float d), return, Depth, (d));
 
@@ -208,6 +287,15 @@ void ftglGetFontBBox(FTGLfont *f, const char* s, int len, float c[6])
 C_FUN(float, ftglGetFontAdvance, (FTGLfont *f, char const *s),
       return 0.0, Advance, (s));
 
+// unsigned int FTFont::Preload(const char* string);
+C_FUN(unsigned int, ftglPreloadFont, (FTGLfont *f, char const *s),
+      return 0, Preload, (s));
+
+// unsigned int FTFont::Preload(unsigned int first, unsigned int last);
+C_FUN(unsigned int, ftglPreloadFontRange, (FTGLfont *f, unsigned int first,
+                                           unsigned int last),
+      return 0, Preload, (first, last));
+
 // virtual void Render(const char* string, int renderMode);
 extern "C++" {
 C_FUN(static FTPoint, _ftglRenderFont, (FTGLfont *f, char const *s, int len,
@@ -220,6 +308,22 @@ void ftglRenderFont(FTGLfont *f, const char *s, int mode)
     _ftglRenderFont(f, s, -1, FTPoint(), FTPoint(), mode);
 }
 
+// virtual void Render(const char* string, const FTGLcolorrun* runs,
+//                     unsigned int runCount, int renderMode);
+extern "C++" {
+C_FUN(static FTPoint, _ftglRenderFontRuns, (FTGLfont *f, char const *s,
+                                            const FTGLcolorrun *runs,
+                                            unsigned int count, int mode),
+      return static_ftpoint, Render, (s, runs, count, -1, FTPoint(),
+                                      FTPoint(), mode));
+}
+
+void ftglRenderFontRuns(FTGLfont *f, const char *s, const FTGLcolorrun *runs,
+                        unsigned int count, int mode)
+{
+    _ftglRenderFontRuns(f, s, runs, count, mode);
+}
+
 // FT_Error FTFont::Error() const;
 C_FUN(FT_Error, ftglGetFontError, (FTGLfont *f), return -1, Error, ());
 
@@ -30,6 +30,7 @@
 #include "FTGL/ftgles.h"
 
 #include "FTFace.h"
+#include "FTVector.h"
 
 class FTGlyphContainer;
 class FTGlyph;
@@ -37,6 +38,7 @@ class FTGlyph;
 class FTFontImpl
 {
         friend class FTFont;
+        friend class FTTextBlockImpl;
 
     protected:
         FTFontImpl(FTFont *ftFont, char const *fontFilePath);
@@ -72,6 +74,8 @@ class FTFontImpl
 
         virtual unsigned int FaceSize() const;
 
+        virtual void CachedSizes(unsigned int count);
+
         virtual void Depth(float depth);
 
         virtual void Outset(float outset);
@@ -86,12 +90,24 @@ class FTFontImpl
 
         virtual float Advance(const wchar_t *s, const int len, FTPoint);
 
+        virtual unsigned int Preload(const char *s, const int len);
+
+        virtual unsigned int Preload(const wchar_t *s, const int len);
+
+        virtual unsigned int Preload(unsigned int first, unsigned int last);
+
         virtual FTPoint Render(const char *s, const int len,
                                FTPoint, FTPoint, int);
 
         virtual FTPoint Render(const wchar_t *s, const int len,
                                FTPoint, FTPoint, int);
 
+        /**
+         * Whether the glyphs are drawn as textured quads a capture can
+         * take instead of the backend.
+         */
+        virtual bool RendersQuads() const { return false; }
+
 	virtual void PreRender() {}
 	
 	
@@ -124,6 +140,53 @@ virtual	void PostRender() {}
          */
         FT_Error err;
 
+        /**
+         * Incremented whenever glyph geometry or textures that have already
+         * been rendered are replaced, so recorded text knows to rebuild.
+         */
+        unsigned int generation;
+
+        /**
+         * The face index of the glyph MakeGlyph is being asked to build,
+         * and the character it is for.
+         */
+        unsigned int glyphIndex;
+        unsigned int charCode;
+
+        /**
+         * The colour runs of the string being rendered, if any.
+         */
+        const FTGL::FTGLcolorrun* colorRuns;
+        unsigned int colorRunCount;
+
+        /**
+         * Unload a glyph made by this font for a character, so it is made
+         * again the next time it is needed.
+         */
+        void RemoveGlyph(const FTGlyph* glyph, unsigned int characterCode);
+
+        /**
+         * The glyph already made for a character, or NULL.
+         */
+        FTGlyph* LoadedGlyph(unsigned int characterCode) const;
+
+        /**
+         * Add a glyph made other than by MakeGlyph, such as from a cache.
+         */
+        void AddGlyph(FTGlyph* glyph, unsigned int characterCode);
+
+        /**
+         * Called before the glyphs made at a size no longer kept are
+         * deleted.
+         */
+        virtual void ReleaseSize(const FTSize& size, FTGlyphContainer* glyphs) {}
+
+        /**
+         * Unload the glyphs of every size, for when glyphs are to be made
+         * differently. FaceSize must be called again.
+         */
+        void DropSizes();
+
     private:
         /**
          * A link back to the interface of which we are the implementation.
@@ -148,6 +211,32 @@ virtual	void PostRender() {}
          */
         FTPoint pen;
 
+        /**
+         * The glyphs of the sizes set most recently, including the current
+         * one, and the most to keep.
+         */
+        struct CachedSize
+        {
+            unsigned int size, res;
+            FTSize charSize;
+            FTGlyphContainer* glyphList;
+            unsigned int lastUsed;
+        };
+
+        FTVector<CachedSize> sizeCache;
+        unsigned int sizeLimit;
+        unsigned int sizeClock;
+
+        /**
+         * Drop the least recently set sizes other than the current one
+         * until at most count are kept.
+         */
+        void TrimSizes(unsigned int count);
+
+        void DropSize(unsigned int index);
+
+        int FindSize(const FTGlyphContainer* glyphs) const;
+
         /* Internal generic BBox() implementation */
         template <typename T>
         inline FTBBox BBoxI(const T *s, const int len,
@@ -157,10 +246,28 @@ virtual	void PostRender() {}
         template <typename T>
         inline float AdvanceI(const T *s, const int len, FTPoint spacing);
 
+        /* Internal generic Preload() implementation */
+        template <typename T>
+        inline unsigned int PreloadI(const T *s, const int len);
+
         /* Internal generic Render() implementation */
         template <typename T>
         inline FTPoint RenderI(const T *s, const int len,
                                FTPoint position, FTPoint spacing, int mode);
+
+        /* Internal generic Render() to sink implementation */
+        template <typename T>
+        inline FTPoint RenderSinkI(const T *s, FTQuadSink& sink,
+                                   const int len, FTPoint position,
+                                   FTPoint spacing);
+
+        /* Internal generic Render() with colour runs implementation */
+        template <typename T>
+        inline FTPoint RenderRunsI(const T *s,
+                                   const FTGL::FTGLcolorrun* runs,
+                                   unsigned int runCount, const int len,
+                                   FTPoint position, FTPoint spacing,
+                                   int mode);
 };
 
 #endif  //  __FTFontImpl__
@@ -116,7 +116,6 @@ inline FTPoint FTOutlineFontImpl::RenderI(const T* string, const int len,
 void FTOutlineFontImpl::PreRender()
 {
 	preRendered = true;
-	GLfloat colors[4];
     glDisable(GL_TEXTURE_2D);
     glEnable(GL_LINE_SMOOTH);
     glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
@@ -124,8 +123,7 @@ void FTOutlineFontImpl::PreRender()
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // GL_ONE
 	glBindTexture(GL_TEXTURE_2D, 0);
 	
-	glGetFloatv(GL_CURRENT_COLOR, colors);
-	ftglColor4f(colors[0], colors[1], colors[2], colors[3]);
+	ftglesLoadCurrentColor();
 	ftglBegin(GL_LINES);
 }
 
@@ -75,6 +75,7 @@ FTPolygonFontImpl::FTPolygonFontImpl(FTFont *ftFont, const char* fontFilePath)
   outset(0.0f)
 {
     load_flags = FT_LOAD_NO_HINTING;
+    preRendered = false;
 }
 
 
@@ -85,5 +86,61 @@ FTPolygonFontImpl::FTPolygonFontImpl(FTFont *ftFont,
   outset(0.0f)
 {
     load_flags = FT_LOAD_NO_HINTING;
+    preRendered = false;
 }
 
+
+template <typename T>
+inline FTPoint FTPolygonFontImpl::RenderI(const T* string, const int len,
+                                          FTPoint position, FTPoint spacing,
+                                          int renderMode)
+{
+    FTPoint tmp;
+
+    if(preRendered)
+    {
+        tmp = FTFontImpl::Render(string, len, position, spacing, renderMode);
+    }
+    else
+    {
+        PreRender();
+        tmp = FTFontImpl::Render(string, len, position, spacing, renderMode);
+        PostRender();
+    }
+
+    return tmp;
+}
+
+
+void FTPolygonFontImpl::PreRender()
+{
+    preRendered = true;
+
+    // Every glyph of the string goes into this one triangle list, which
+    // the backend draws untextured
+    ftglesLoadCurrentColor();
+    ftglBegin(GL_TRIANGLES);
+}
+
+
+void FTPolygonFontImpl::PostRender()
+{
+    preRendered = false;
+    ftglEnd();
+}
+
+
+FTPoint FTPolygonFontImpl::Render(const char * string, const int len,
+                                  FTPoint position, FTPoint spacing,
+                                  int renderMode)
+{
+    return RenderI(string, len, position, spacing, renderMode);
+}
+
+
+FTPoint FTPolygonFontImpl::Render(const wchar_t * string, const int len,
+                                  FTPoint position, FTPoint spacing,
+                                  int renderMode)
+{
+    return RenderI(string, len, position, spacing, renderMode);
+}
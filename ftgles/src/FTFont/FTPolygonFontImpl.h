@@ -49,11 +49,34 @@ class FTPolygonFontImpl : public FTFontImpl
          */
         virtual void Outset(float o) { outset = o; }
 
+        virtual FTPoint Render(const char *s, const int len,
+                               FTPoint position, FTPoint spacing,
+                               int renderMode);
+
+        virtual FTPoint Render(const wchar_t *s, const int len,
+                               FTPoint position, FTPoint spacing,
+                               int renderMode);
+
+        virtual void PreRender();
+
+        virtual void PostRender();
+
     private:
         /**
          * The outset distance (front and back) for the font.
          */
         float outset;
+
+        /**
+         * Set between PreRender and PostRender, while a triangle batch
+         * is open.
+         */
+        bool preRendered;
+
+        /* Internal generic Render() implementation */
+        template <typename T>
+        inline FTPoint RenderI(const T *s, const int len,
+                               FTPoint position, FTPoint spacing, int mode);
 };
 
 #endif  //  __FTPolygonFontImpl__
@@ -27,14 +27,25 @@
 #include "config.h"
 
 #include <cassert>
+#include <cstdio>
 #include <string> // For memset
+#include <wchar.h>
+
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "FTGL/ftgles.h"
+#include FT_TRUETYPE_TABLES_H
+#include FT_TRUETYPE_TAGS_H
 
 #include "FTInternals.h"
 
 #include "../FTGlyph/FTTextureGlyphImpl.h"
 #include "./FTTextureFontImpl.h"
+#include "FTAtlas.h"
 
 
 //
@@ -57,6 +68,84 @@ FTTextureFont::~FTTextureFont()
 {}
 
 
+float FTTextureFont::Occupancy() const
+{
+    FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
+    return myimpl ? myimpl->Occupancy() : 0.0f;
+}
+
+
+void FTTextureFont::PageSize(unsigned int size)
+{
+    FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
+    if(myimpl)
+    {
+        myimpl->PageSize(size);
+    }
+}
+
+
+void FTTextureFont::PageBudget(unsigned int pages)
+{
+    FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
+    if(myimpl)
+    {
+        myimpl->PageBudget(pages);
+    }
+}
+
+
+unsigned int FTTextureFont::PageCount() const
+{
+    FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
+    return myimpl ? myimpl->PageCount() : 0;
+}
+
+
+void FTTextureFont::AtlasManager(FTAtlasManager* manager)
+{
+    FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
+    if(myimpl)
+    {
+        myimpl->SetAtlas(manager ? manager->impl : NULL);
+    }
+}
+
+
+void FTTextureFont::DistanceField(unsigned int referenceSize)
+{
+    FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
+    if(myimpl)
+    {
+        myimpl->DistanceField(referenceSize);
+    }
+}
+
+
+void FTTextureFont::SubpixelPositions(unsigned int phases)
+{
+    FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
+    if(myimpl)
+    {
+        myimpl->SubpixelPositions(phases);
+    }
+}
+
+
+bool FTTextureFont::SaveCache(const char* path)
+{
+    FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
+    return myimpl ? myimpl->SaveCache(path) : false;
+}
+
+
+bool FTTextureFont::LoadCache(const char* path)
+{
+    FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
+    return myimpl ? myimpl->LoadCache(path) : false;
+}
+
+
 FTGlyph* FTTextureFont::MakeGlyph(FT_GlyphSlot ftGlyph)
 {
     FTTextureFontImpl *myimpl = dynamic_cast<FTTextureFontImpl *>(impl);
@@ -96,8 +185,18 @@ FTTextureFontImpl::FTTextureFontImpl(FTFont *ftFont, const char* fontFilePath)
     glyphHeight(0),
     glyphWidth(0),
     padding(3),
-    xOffset(0),
-    yOffset(0)
+    atlas(new FTAtlas),
+    sharedAtlas(false),
+    faceKey(0),
+    batchUploads(false),
+    fieldReference(0),
+    fieldSpread(0),
+    fieldScale(1.0f),
+    fieldSized(false),
+    faceSize(0),
+    faceResolution(72),
+    subpixelPhases(1),
+    variantGlyph(NULL)
 {
     load_flags = FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP;
     remGlyphs = numGlyphs = face.GlyphCount();
@@ -115,116 +214,989 @@ FTTextureFontImpl::FTTextureFontImpl(FTFont *ftFont,
     glyphHeight(0),
     glyphWidth(0),
     padding(3),
-    xOffset(0),
-    yOffset(0)
+    atlas(new FTAtlas),
+    sharedAtlas(false),
+    faceKey(0),
+    batchUploads(false),
+    fieldReference(0),
+    fieldSpread(0),
+    fieldScale(1.0f),
+    fieldSized(false),
+    faceSize(0),
+    faceResolution(72),
+    subpixelPhases(1),
+    variantGlyph(NULL)
 {
     load_flags = FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP;
     remGlyphs = numGlyphs = face.GlyphCount();
+	preRendered = false;
 }
 
 
 FTTextureFontImpl::~FTTextureFontImpl()
 {
-    if(textureIDList.size())
+    atlas->ReleaseFont(this, false);
+    atlas->Release();
+}
+
+
+/*
+ * Identifies the face for atlas keys and cache files, so fonts opened
+ * separately from the same file share bitmaps, and a revised file does
+ * not. For SFNT fonts the table directory's checksums and the head table,
+ * with its checksum adjustment and revision, stand for the font's data.
+ */
+static unsigned long FaceKey(FT_Face face)
+{
+    unsigned long h = 2166136261u;
+    const char *names[2] = { face->family_name, face->style_name };
+
+    for(int n = 0; n < 2; ++n)
+    {
+        for(const char *c = names[n]; c && *c; ++c)
+        {
+            h = (h ^ static_cast<unsigned char>(*c)) * 16777619u;
+        }
+        h = (h ^ 0xff) * 16777619u;
+    }
+
+    h = (h ^ static_cast<unsigned long>(face->num_glyphs)) * 16777619u;
+    h = (h ^ static_cast<unsigned long>(face->face_index)) * 16777619u;
+
+    if(!FT_IS_SFNT(face))
+    {
+        return h;
+    }
+
+    // The offset table is 12 bytes, then 16 per table. For a collection
+    // this is the collection's header instead, which the face index
+    // already tells apart.
+    FT_Byte directory[12 + 16 * 64];
+    FT_ULong length = 12;
+
+    if(!FT_Load_Sfnt_Table(face, 0, 0, directory, &length))
+    {
+        FT_ULong tables = (directory[4] << 8) | directory[5];
+        length = 12 + 16 * (tables > 64 ? 64 : tables);
+
+        if(!FT_Load_Sfnt_Table(face, 0, 0, directory, &length))
+        {
+            for(FT_ULong i = 0; i < length; ++i)
+            {
+                h = (h ^ directory[i]) * 16777619u;
+            }
+        }
+    }
+
+    FT_Byte head[54];
+    length = sizeof(head);
+
+    if(!FT_Load_Sfnt_Table(face, TTAG_head, 0, head, &length))
+    {
+        for(FT_ULong i = 0; i < length; ++i)
+        {
+            h = (h ^ head[i]) * 16777619u;
+        }
+    }
+
+    return h;
+}
+
+
+FTAtlasKey FTTextureFontImpl::GlyphKey(unsigned int index,
+                                       unsigned int variant)
+{
+    FT_Face ftFace = *face.Face();
+    FTAtlasKey key;
+
+    if(!faceKey)
     {
-        glDeleteTextures((GLsizei)textureIDList.size(),
-                         (const GLuint*)&textureIDList[0]);
+        faceKey = FaceKey(ftFace);
     }
+    key.face = faceKey;
+    key.xScale = ftFace->size->metrics.x_scale;
+    key.yScale = ftFace->size->metrics.y_scale;
+    key.glyph = index;
+    key.variant = variant;
+
+    return key;
 }
 
 
 FTGlyph* FTTextureFontImpl::MakeGlyphImpl(FT_GlyphSlot ftGlyph)
 {
-    glyphHeight = static_cast<int>(charSize.Height() + 0.5);
-    glyphWidth = static_cast<int>(charSize.Width() + 0.5);
+    // Pack the glyph by the size of its own bitmap, not the face's
+    // bounding box. FTTextureGlyph will find the slot already rendered.
+    int x = 0, y = 0;
+    int width = 0, height = 0;
+    int entry = -1;
+    bool found = false;
+    GLuint texture = atlas->CurrentTexture();
+    FTAtlas::Page *page = NULL;
+    const FT_Bitmap& bitmap = ftGlyph->bitmap;
 
-    if(glyphHeight < 1) glyphHeight = 1;
-    if(glyphWidth < 1) glyphWidth = 1;
-	
-    if(textureIDList.empty())
+    if(!FT_Render_Glyph(ftGlyph, FT_RENDER_MODE_NORMAL))
+    {
+        width = bitmap.width;
+        height = bitmap.rows;
+    }
+
+    // A distance field reaches past the bitmap on every side
+    int spread = fieldReference ? fieldSpread : 0;
+    int imageWidth = FTDistanceField::FieldSize(width, spread);
+    int imageHeight = FTDistanceField::FieldSize(height, spread);
+
+    if(width && height)
     {
-        textureIDList.push_back(CreateTexture());
-        xOffset = yOffset = padding;
+        FTAtlasKey key = GlyphKey(glyphIndex, spread ? FTAtlas::DISTANCE
+                                                     : FTAtlas::COVERAGE);
+
+        CalculateTextureSize();
+        entry = atlas->Place(key, imageWidth + padding, imageHeight + padding,
+                             textureWidth, textureHeight, x, y, found);
+        x += padding;
+        y += padding;
+
+        // A page taking new glyphs, even preloaded ones, is in use
+        page = atlas->EntryPage(entry);
+        page->lastUsed = *atlas->Clock();
+        texture = page->texture;
     }
 
-    if(xOffset > (textureWidth - glyphWidth))
+    if(page && !found)
     {
-        xOffset = padding;
-        yOffset += glyphHeight;
+        if(spread)
+        {
+            fieldPixels.resize(imageWidth * imageHeight, 0);
+            field.Generate(bitmap.buffer, width, height, bitmap.pitch,
+                           spread, &fieldPixels[0]);
+            atlas->Write(entry, x, y, &fieldPixels[0], imageWidth,
+                         imageHeight, imageWidth);
+        }
+        else
+        {
+            atlas->Write(entry, x, y, bitmap.buffer, width, height,
+                         bitmap.pitch);
+        }
 
-        if(yOffset > (textureHeight - glyphHeight))
+        // Preload uploads everything it made at once
+        if(!batchUploads)
         {
-            textureIDList.push_back(CreateTexture());
-            yOffset = padding;
+            atlas->Upload();
         }
     }
 
-    FTTextureGlyph* tempGlyph = new FTTextureGlyph(ftGlyph, textureIDList[textureIDList.size() - 1],
-                                                    xOffset, yOffset, textureWidth, textureHeight);
-    xOffset += static_cast<int>(tempGlyph->BBox().Upper().X() - tempGlyph->BBox().Lower().X() + padding + 0.5);
+    FTTextureGlyph* tempGlyph = new FTTextureGlyph(ftGlyph, texture, x, y,
+                                                    page ? page->width : 1,
+                                                    page ? page->height : 1,
+                                                    false);
+
+    FTTextureGlyphImpl *glyphImpl =
+        dynamic_cast<FTTextureGlyphImpl *>(tempGlyph->impl);
+
+    if(page)
+    {
+        glyphImpl->pageUsed = &page->lastUsed;
+        glyphImpl->renderCount = atlas->Clock();
+    }
+
+    if(fieldReference)
+    {
+        if(page)
+        {
+            glyphImpl->Image(FTPoint(ftGlyph->bitmap_left - spread,
+                                     ftGlyph->bitmap_top + spread),
+                             imageWidth, imageHeight, x, y,
+                             page->width, page->height);
+        }
+        glyphImpl->scale = &fieldScale;
+    }
+    SetupVariants(tempGlyph, glyphIndex);
+    glyphImpl->charCode = charCode;
+    glyphImpl->atlasOwner = atlas->AddOwner(entry, this, tempGlyph, charCode,
+                                            -1);
 	
-	--remGlyphs;
+	// Remade glyphs can outnumber the face's
+	if(remGlyphs)
+	{
+		--remGlyphs;
+	}
 
     return tempGlyph;
 }
 
 
+/*
+ * Glyph cache files: a header, then a record per page and per glyph, then
+ * the pages' pixels. Everything is in the writer's byte order, which the
+ * header's byteOrder field lets a reader check.
+ */
+static const char CACHE_MAGIC[8] = { 'F', 'T', 'G', 'L', 'E', 'S', 'A', 'C' };
+static const uint32_t CACHE_VERSION = 2;
+static const uint32_t CACHE_BYTE_ORDER = 0x01020304;
+static const uint32_t CACHE_NO_PAGE = 0xffffffff;
+
+struct FTCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t faceKey[2];
+    int32_t xScale;
+    int32_t yScale;
+    int32_t loadFlags;
+    uint32_t fieldReference;
+    uint32_t pageCount;
+    uint32_t glyphCount;
+};
+
+struct FTCachePage
+{
+    uint32_t width;
+    uint32_t height;
+};
+
+struct FTCacheGlyph
+{
+    uint32_t charCode;
+    uint32_t glyphIndex;
+    uint32_t page;
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    float corner[2];
+    float advance[2];
+    float bbox[6];
+};
+
+
+void FTTextureFontImpl::CacheHeader(void* data)
+{
+    FTCacheHeader *header = static_cast<FTCacheHeader *>(data);
+    FT_Face ftFace = *face.Face();
+
+    if(!faceKey)
+    {
+        faceKey = FaceKey(ftFace);
+    }
+
+    memset(header, 0, sizeof(FTCacheHeader));
+    memcpy(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header->version = CACHE_VERSION;
+    header->byteOrder = CACHE_BYTE_ORDER;
+    header->faceKey[0] = static_cast<uint32_t>(faceKey);
+    header->faceKey[1] = static_cast<uint32_t>((faceKey >> 16) >> 16);
+    header->xScale = ftFace->size->metrics.x_scale;
+    header->yScale = ftFace->size->metrics.y_scale;
+    header->loadFlags = load_flags;
+    header->fieldReference = fieldReference;
+}
+
+
+bool FTTextureFontImpl::SaveCache(const char* path)
+{
+    if(!faceSize || !path)
+    {
+        return false;
+    }
+
+    FT_Face ftFace = *face.Face();
+    FTVector<FTCacheGlyph> glyphs;
+    FTVector<int> pageMap;
+    FTVector<int> savedPages;
+
+    pageMap.resize(atlas->PageCount(), -1);
+
+    FT_UInt index;
+    for(FT_ULong c = FT_Get_First_Char(ftFace, &index); index;
+        c = FT_Get_Next_Char(ftFace, c, &index))
+    {
+        FTGlyph *glyph = LoadedGlyph(c);
+        FTTextureGlyphImpl *glyphImpl = glyph
+            ? dynamic_cast<FTTextureGlyphImpl *>(glyph->impl) : NULL;
+
+        if(!glyphImpl)
+        {
+            continue;
+        }
+
+        FTCacheGlyph record;
+        memset(&record, 0, sizeof(record));
+        record.charCode = c;
+        record.glyphIndex = index;
+        record.page = CACHE_NO_PAGE;
+
+        int page = -1;
+        if(glyphImpl->destWidth && glyphImpl->destHeight)
+        {
+            page = atlas->PageIndex(glyphImpl->glTextureID);
+        }
+
+        if(page >= 0)
+        {
+            FTAtlas::Page *p = atlas->PageAt(page);
+
+            if(pageMap[page] < 0)
+            {
+                pageMap[page] = savedPages.size();
+                savedPages.push_back(page);
+            }
+
+            record.page = pageMap[page];
+            record.x = static_cast<int32_t>(glyphImpl->uv[0].Xf() * p->width
+                                            + 0.5f);
+            record.y = static_cast<int32_t>(glyphImpl->uv[0].Yf() * p->height
+                                            + 0.5f);
+            record.width = glyphImpl->destWidth;
+            record.height = glyphImpl->destHeight;
+            record.corner[0] = glyphImpl->corner.Xf();
+            record.corner[1] = glyphImpl->corner.Yf();
+        }
+
+        record.advance[0] = glyphImpl->advance.Xf();
+        record.advance[1] = glyphImpl->advance.Yf();
+        record.bbox[0] = glyphImpl->bBox.Lower().Xf();
+        record.bbox[1] = glyphImpl->bBox.Lower().Yf();
+        record.bbox[2] = glyphImpl->bBox.Lower().Zf();
+        record.bbox[3] = glyphImpl->bBox.Upper().Xf();
+        record.bbox[4] = glyphImpl->bBox.Upper().Yf();
+        record.bbox[5] = glyphImpl->bBox.Upper().Zf();
+
+        glyphs.push_back(record);
+    }
+
+    FTCacheHeader header;
+    CacheHeader(&header);
+    header.pageCount = savedPages.size();
+    header.glyphCount = glyphs.size();
+
+    FILE *file = fopen(path, "wb");
+    if(!file)
+    {
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for(unsigned int i = 0; ok && i < savedPages.size(); ++i)
+    {
+        FTAtlas::Page *p = atlas->PageAt(savedPages[i]);
+        FTCachePage record;
+        record.width = p->width;
+        record.height = p->height;
+        ok = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+
+    if(ok && glyphs.size())
+    {
+        ok = fwrite(&glyphs[0], sizeof(FTCacheGlyph), glyphs.size(), file)
+             == glyphs.size();
+    }
+
+    for(unsigned int i = 0; ok && i < savedPages.size(); ++i)
+    {
+        FTAtlas::Page *p = atlas->PageAt(savedPages[i]);
+        size_t bytes = p->width * p->height;
+        ok = fwrite(p->pixels, 1, bytes, file) == bytes;
+    }
+
+    return fclose(file) == 0 && ok;
+}
+
+
+bool FTTextureFontImpl::LoadCache(const char* path)
+{
+    if(!faceSize || !path)
+    {
+        return false;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) || info.st_size < (off_t)sizeof(FTCacheHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    size_t size = info.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(map == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const unsigned char *data = static_cast<const unsigned char *>(map);
+    const FTCacheHeader *header =
+        reinterpret_cast<const FTCacheHeader *>(data);
+    FTCacheHeader expected;
+    CacheHeader(&expected);
+
+    // Refuse files from another face, size, glyph format or machine
+    bool ok = !memcmp(header->magic, expected.magic, sizeof(CACHE_MAGIC))
+              && header->version == expected.version
+              && header->byteOrder == expected.byteOrder
+              && header->faceKey[0] == expected.faceKey[0]
+              && header->faceKey[1] == expected.faceKey[1]
+              && header->xScale == expected.xScale
+              && header->yScale == expected.yScale
+              && header->loadFlags == expected.loadFlags
+              && header->fieldReference == expected.fieldReference;
+
+    const FTCachePage *pageRecords =
+        reinterpret_cast<const FTCachePage *>(header + 1);
+    const FTCacheGlyph *glyphRecords =
+        reinterpret_cast<const FTCacheGlyph *>(pageRecords
+                                               + (ok ? header->pageCount : 0));
+    FTVector<size_t> pixelOffsets;
+
+    if(ok)
+    {
+        size_t offset = sizeof(FTCacheHeader)
+                      + header->pageCount * sizeof(FTCachePage)
+                      + header->glyphCount * sizeof(FTCacheGlyph);
+
+        ok = header->pageCount < size && header->glyphCount < size
+             && offset <= size;
+
+        for(unsigned int i = 0; ok && i < header->pageCount; ++i)
+        {
+            size_t bytes = static_cast<size_t>(pageRecords[i].width)
+                         * pageRecords[i].height;
+
+            ok = pageRecords[i].width && pageRecords[i].height
+                 && bytes / pageRecords[i].width == pageRecords[i].height
+                 && bytes <= size - offset;
+            pixelOffsets.push_back(offset);
+            offset += bytes;
+        }
+    }
+
+    for(unsigned int i = 0; ok && i < header->glyphCount; ++i)
+    {
+        const FTCacheGlyph& g = glyphRecords[i];
+
+        if(g.page == CACHE_NO_PAGE)
+        {
+            continue;
+        }
+
+        ok = g.page < header->pageCount && g.x >= 0 && g.y >= 0
+             && g.width > 0 && g.height > 0
+             && g.x <= (int32_t)pageRecords[g.page].width - g.width
+             && g.y <= (int32_t)pageRecords[g.page].height - g.height;
+    }
+
+    if(!ok)
+    {
+        munmap(map, size);
+        return false;
+    }
+
+    // Pages are only added for glyphs the atlas lacks
+    FTVector<int> adopted;
+    adopted.resize(header->pageCount, -1);
+
+    for(unsigned int i = 0; i < header->glyphCount; ++i)
+    {
+        const FTCacheGlyph& g = glyphRecords[i];
+
+        if(LoadedGlyph(g.charCode))
+        {
+            continue;
+        }
+
+        FTTextureGlyph *glyph = new FTTextureGlyph(NULL, 0, 0, 0, 1, 1,
+                                                   false);
+        FTTextureGlyphImpl *glyphImpl =
+            dynamic_cast<FTTextureGlyphImpl *>(glyph->impl);
+        int entry = -1;
+
+        glyphImpl->advance = FTPoint(g.advance[0], g.advance[1]);
+        glyphImpl->bBox = FTBBox(g.bbox[0], g.bbox[1], g.bbox[2],
+                                 g.bbox[3], g.bbox[4], g.bbox[5]);
+
+        if(g.page != CACHE_NO_PAGE)
+        {
+            FTAtlasKey key = GlyphKey(g.glyphIndex,
+                                      fieldReference ? FTAtlas::DISTANCE
+                                                     : FTAtlas::COVERAGE);
+
+            if(atlas->Find(key) < 0 && adopted[g.page] < 0)
+            {
+                adopted[g.page] = atlas->AdoptPage(pageRecords[g.page].width,
+                                                   pageRecords[g.page].height,
+                                                   data
+                                                   + pixelOffsets[g.page]);
+            }
+
+            // A glyph the atlas already has is drawn from its own copy
+            int page = adopted[g.page];
+            int x = g.x - padding;
+            int y = g.y - padding;
+            entry = atlas->Adopt(key, page, x, y, g.width + padding,
+                                 g.height + padding);
+
+            FTAtlas::Page *p = atlas->PageAt(page);
+            glyphImpl->Image(FTPoint(g.corner[0], g.corner[1]), g.width,
+                             g.height, x + padding, y + padding,
+                             p->width, p->height);
+            glyphImpl->glTextureID = p->texture;
+            glyphImpl->pageUsed = &p->lastUsed;
+            glyphImpl->renderCount = atlas->Clock();
+        }
+
+        if(fieldReference)
+        {
+            glyphImpl->scale = &fieldScale;
+        }
+
+        SetupVariants(glyph, g.glyphIndex);
+        AddGlyph(glyph, g.charCode);
+        glyphImpl->charCode = g.charCode;
+        glyphImpl->atlasOwner = atlas->AddOwner(entry, this, glyph,
+                                                g.charCode, -1);
+
+        if(remGlyphs)
+        {
+            --remGlyphs;
+        }
+    }
+
+    munmap(map, size);
+    return true;
+}
+
+
+void FTTextureFontImpl::Evicted(FTGlyph* glyph, unsigned int charCode)
+{
+    // Recorded text may point at the evicted glyphs
+    generation++;
+
+    if(glyph != variantGlyph)
+    {
+        RemoveGlyph(glyph, charCode);
+        return;
+    }
+
+    // The glyph is being drawn, so only its images go
+    FTTextureGlyphImpl *glyphImpl =
+        dynamic_cast<FTTextureGlyphImpl *>(glyph->impl);
+
+    for(unsigned int i = 0; i < glyphImpl->variants.size(); ++i)
+    {
+        glyphImpl->variants[i] = FTTextureGlyphImpl::Variant();
+    }
+    glyphImpl->destWidth = glyphImpl->destHeight = 0;
+    glyphImpl->pageUsed = NULL;
+    glyphImpl->atlasOwner = -1;
+}
+
+
+void FTTextureFontImpl::SetupVariants(FTTextureGlyph* glyph,
+                                      unsigned int index)
+{
+    if(subpixelPhases < 2 || fieldReference)
+    {
+        return;
+    }
+
+    FTTextureGlyphImpl *glyphImpl =
+        dynamic_cast<FTTextureGlyphImpl *>(glyph->impl);
+
+    glyphImpl->variantFont = this;
+    glyphImpl->owner = glyph;
+    glyphImpl->glyphIndex = index;
+    glyphImpl->variants.resize(subpixelPhases, FTTextureGlyphImpl::Variant());
+
+    FTTextureGlyphImpl::Variant& whole = glyphImpl->variants[0];
+    whole.made = true;
+    whole.texture = glyphImpl->glTextureID;
+    whole.width = glyphImpl->destWidth;
+    whole.height = glyphImpl->destHeight;
+    whole.corner = glyphImpl->corner;
+    whole.uv[0] = glyphImpl->uv[0];
+    whole.uv[1] = glyphImpl->uv[1];
+    whole.pageUsed = glyphImpl->pageUsed;
+}
+
+
+void FTTextureFontImpl::MakeVariant(FTTextureGlyphImpl* glyph,
+                                    unsigned int phase)
+{
+    FTTextureGlyphImpl::Variant variant;
+    variant.made = true;
+
+    // A shift in 26.6 fixed point, as the outline is
+    FT_Pos shift = phase * 64 / glyph->variants.size();
+    FT_GlyphSlot slot = face.Glyph(glyph->glyphIndex, load_flags);
+
+    if(slot && slot->format == FT_GLYPH_FORMAT_OUTLINE)
+    {
+        FT_Outline_Translate(&slot->outline, shift, 0);
+    }
+
+    if(!slot || FT_Render_Glyph(slot, FT_RENDER_MODE_NORMAL)
+       || !slot->bitmap.width || !slot->bitmap.rows)
+    {
+        glyph->variants[phase] = variant;
+        return;
+    }
+
+    const FT_Bitmap& bitmap = slot->bitmap;
+    FTAtlasKey key = GlyphKey(glyph->glyphIndex,
+                              shift ? FTAtlas::SHIFTED + shift
+                                    : FTAtlas::COVERAGE);
+    int x, y;
+    bool found;
+
+    CalculateTextureSize();
+
+    variantGlyph = glyph->owner;
+    int entry = atlas->Place(key, bitmap.width + padding,
+                             bitmap.rows + padding, textureWidth,
+                             textureHeight, x, y, found);
+    variantGlyph = NULL;
+
+    x += padding;
+    y += padding;
+
+    FTAtlas::Page *page = atlas->EntryPage(entry);
+    page->lastUsed = *atlas->Clock();
+
+    if(!found)
+    {
+        atlas->Write(entry, x, y, bitmap.buffer, bitmap.width, bitmap.rows,
+                     bitmap.pitch);
+        atlas->Upload();
+    }
+
+    variant.texture = page->texture;
+    variant.width = bitmap.width;
+    variant.height = bitmap.rows;
+    variant.corner = FTPoint(slot->bitmap_left, slot->bitmap_top);
+    variant.uv[0] = FTPoint(static_cast<float>(x) / page->width,
+                            static_cast<float>(y) / page->height);
+    variant.uv[1] = FTPoint(static_cast<float>(x + variant.width)
+                            / page->width,
+                            static_cast<float>(y + variant.height)
+                            / page->height);
+    variant.pageUsed = &page->lastUsed;
+    glyph->variants[phase] = variant;
+
+    // The whole pixel image, made again after an eviction
+    if(!phase)
+    {
+        glyph->Image(variant.corner, variant.width, variant.height, x, y,
+                     page->width, page->height);
+        glyph->glTextureID = page->texture;
+        glyph->pageUsed = &page->lastUsed;
+    }
+
+    glyph->atlasOwner = atlas->AddOwner(entry, this, glyph->owner,
+                                        glyph->charCode, glyph->atlasOwner);
+}
+
+
+void FTTextureFontImpl::ReleaseSize(const FTSize& size,
+                                    FTGlyphContainer* glyphs)
+{
+    if(sharedAtlas)
+    {
+        // The bitmaps stay for other fonts
+        atlas->ReleaseScale(this, size.XScale(), size.YScale());
+        return;
+    }
+
+    // The font's own pages cannot give back one size's space, so start
+    // them again; the sizes still kept make their glyphs as needed
+    atlas->ReleaseFont(this, true);
+    atlas->Clear();
+}
+
+
+void FTTextureFontImpl::SetAtlas(FTAtlas* shared)
+{
+    if(!shared && !sharedAtlas)
+    {
+        return;
+    }
+
+    // Every glyph points into the old atlas
+    atlas->ReleaseFont(this, true);
+    atlas->Release();
+
+    sharedAtlas = shared != NULL;
+    atlas = shared ? shared : new FTAtlas;
+    if(shared)
+    {
+        shared->Retain();
+    }
+}
+
+
+float FTTextureFontImpl::Occupancy() const
+{
+    return atlas->Occupancy();
+}
+
+
+void FTTextureFontImpl::PageSize(unsigned int size)
+{
+    atlas->PageSize(size);
+}
+
+
+void FTTextureFontImpl::PageBudget(unsigned int budget)
+{
+    atlas->PageBudget(budget);
+}
+
+
+unsigned int FTTextureFontImpl::PageCount() const
+{
+    return atlas->PageCount();
+}
+
+
 void FTTextureFontImpl::CalculateTextureSize()
 {
-    //if(!maximumGLTextureSize)
-   // {
-    //    maximumGLTextureSize = 512;
-   //     glGetIntegerv(GL_MAX_TEXTURE_SIZE, (GLint*)&maximumGLTextureSize);
-    //    assert(maximumGLTextureSize); // If you hit this then you have an invalid OpenGL context.
-   // }
-	maximumGLTextureSize = 1024;
+    glyphHeight = static_cast<int>(charSize.Height() + 0.5);
+    glyphWidth = static_cast<int>(charSize.Width() + 0.5);
+
+    if(glyphHeight < 1) glyphHeight = 1;
+    if(glyphWidth < 1) glyphWidth = 1;
+
+    if(!maximumGLTextureSize)
+    {
+        maximumGLTextureSize = ftglesMaxTextureSize();
+        if(maximumGLTextureSize <= 0)
+        {
+            maximumGLTextureSize = 1024;
+        }
+    }
+
     textureWidth = NextPowerOf2((remGlyphs * glyphWidth) + (padding * 2));
     textureWidth = textureWidth > maximumGLTextureSize ? maximumGLTextureSize : textureWidth;
 
     int h = static_cast<int>((textureWidth - (padding * 2)) / glyphWidth + 0.5);
+    h = h < 1 ? 1 : h;
 
     textureHeight = NextPowerOf2(((numGlyphs / h) + 1) * glyphHeight);
     textureHeight = textureHeight > maximumGLTextureSize ? maximumGLTextureSize : textureHeight;
 }
 
 
-GLuint FTTextureFontImpl::CreateTexture()
+bool FTTextureFontImpl::FaceSize(const unsigned int size, const unsigned int res)
 {
-	CalculateTextureSize();
+    faceSize = size;
+    faceResolution = res;
 
-    int totalMemory = textureWidth * textureHeight;
-    unsigned char* textureMemory = new unsigned char[totalMemory];
-    memset(textureMemory, 0, totalMemory);
-	
-    GLuint textID;
-    glGenTextures(1, (GLuint*)&textID);
-
-    glBindTexture(GL_TEXTURE_2D, textID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, textureWidth, textureHeight,
-                 0, GL_ALPHA, GL_UNSIGNED_BYTE, textureMemory);
-	
-	printf("texture dimensions: %d %d\n", textureWidth, textureHeight);
-	
-    delete [] textureMemory;
+    if(fieldReference)
+    {
+        fieldScale = static_cast<float>(size * res)
+                   / static_cast<float>(fieldReference * 72);
+
+        // The glyphs stay; text recorded at the old size does not
+        if(fieldSized)
+        {
+            generation++;
+            return true;
+        }
+    }
+
+    remGlyphs = numGlyphs = face.GlyphCount();
+
+    if(fieldReference)
+    {
+        fieldSized = FTFontImpl::FaceSize(fieldReference, 72);
+        return fieldSized;
+    }
 
-    return textID;
+    return FTFontImpl::FaceSize(size, res);
 }
 
 
-bool FTTextureFontImpl::FaceSize(const unsigned int size, const unsigned int res)
+unsigned int FTTextureFontImpl::FaceSize() const
+{
+    return fieldReference ? faceSize : FTFontImpl::FaceSize();
+}
+
+
+void FTTextureFontImpl::DistanceField(unsigned int referenceSize)
 {
-    if(!textureIDList.empty())
+    if(referenceSize == fieldReference)
     {
-        glDeleteTextures((GLsizei)textureIDList.size(), (const GLuint*)&textureIDList[0]);
-        textureIDList.clear();
-        remGlyphs = numGlyphs = face.GlyphCount();
+        return;
     }
 
-    return FTFontImpl::FaceSize(size, res);
+    fieldReference = referenceSize;
+    fieldSpread = referenceSize / 8 < 2 ? 2 : referenceSize / 8;
+    fieldScale = 1.0f;
+    fieldSized = false;
+
+    // Remake the glyphs the new way
+    DropSizes();
+    if(faceSize)
+    {
+        FaceSize(faceSize, faceResolution);
+    }
+}
+
+
+void FTTextureFontImpl::SubpixelPositions(unsigned int phases)
+{
+    phases = phases < 1 ? 1 : phases > 64 ? 64 : phases;
+
+    if(phases == subpixelPhases)
+    {
+        return;
+    }
+
+    // Glyphs are made with a variant per phase
+    subpixelPhases = phases;
+    atlas->ReleaseFont(this, true);
+}
+
+
+float FTTextureFontImpl::Ascender() const
+{
+    return FTFontImpl::Ascender() * fieldScale;
+}
+
+
+float FTTextureFontImpl::Descender() const
+{
+    return FTFontImpl::Descender() * fieldScale;
+}
+
+
+float FTTextureFontImpl::LineHeight() const
+{
+    return FTFontImpl::LineHeight() * fieldScale;
+}
+
+
+FTBBox FTTextureFontImpl::BBox(const char *string, const int len,
+                               FTPoint position, FTPoint spacing)
+{
+    if(!fieldReference)
+    {
+        return FTFontImpl::BBox(string, len, position, spacing);
+    }
+
+    FTBBox box = FTFontImpl::BBox(string, len, position * (1.0 / fieldScale),
+                                  spacing * (1.0 / fieldScale));
+    return FTBBox(box.Lower() * fieldScale, box.Upper() * fieldScale);
+}
+
+
+FTBBox FTTextureFontImpl::BBox(const wchar_t *string, const int len,
+                               FTPoint position, FTPoint spacing)
+{
+    if(!fieldReference)
+    {
+        return FTFontImpl::BBox(string, len, position, spacing);
+    }
+
+    FTBBox box = FTFontImpl::BBox(string, len, position * (1.0 / fieldScale),
+                                  spacing * (1.0 / fieldScale));
+    return FTBBox(box.Lower() * fieldScale, box.Upper() * fieldScale);
+}
+
+
+float FTTextureFontImpl::Advance(const char *string, const int len,
+                                 FTPoint spacing)
+{
+    return FTFontImpl::Advance(string, len, spacing * (1.0 / fieldScale))
+           * fieldScale;
+}
+
+
+float FTTextureFontImpl::Advance(const wchar_t *string, const int len,
+                                 FTPoint spacing)
+{
+    return FTFontImpl::Advance(string, len, spacing * (1.0 / fieldScale))
+           * fieldScale;
+}
+
+
+unsigned int FTTextureFontImpl::Preload(const char *string, const int len)
+{
+    batchUploads = true;
+    unsigned int made = FTFontImpl::Preload(string, len);
+    batchUploads = false;
+
+    atlas->Upload();
+    return made;
+}
+
+
+unsigned int FTTextureFontImpl::Preload(const wchar_t *string, const int len)
+{
+    batchUploads = true;
+    unsigned int made = FTFontImpl::Preload(string, len);
+    batchUploads = false;
+
+    atlas->Upload();
+    return made;
+}
+
+
+unsigned int FTTextureFontImpl::Preload(unsigned int first, unsigned int last)
+{
+    batchUploads = true;
+    unsigned int made = FTFontImpl::Preload(first, last);
+    batchUploads = false;
+
+    atlas->Upload();
+    return made;
+}
+
+
+static inline size_t StringLength(const char* string)
+{
+    return strlen(string);
+}
+
+
+static inline size_t StringLength(const wchar_t* string)
+{
+    return wcslen(string);
+}
+
+
+template <typename T>
+inline FTPoint FTTextureFontImpl::RenderGlyphsI(const T* string,
+                                                const int len,
+                                                FTPoint position,
+                                                FTPoint spacing,
+                                                int renderMode)
+{
+    // A string the batch may not hold could be drawn in part before its
+    // new glyphs are uploaded, so those are made first
+    size_t length = len < 0 ? StringLength(string) : len;
+    if(!ftglesBatchFits(length * 4))
+    {
+        Preload(string, len);
+    }
+
+    // New glyphs go up in one upload, before the batch can be drawn
+    batchUploads = true;
+    FTPoint tmp = FTFontImpl::Render(string, len, position, spacing,
+                                     renderMode);
+    batchUploads = false;
+
+    atlas->Upload();
+    return tmp;
 }
 
 
@@ -235,51 +1207,54 @@ inline FTPoint FTTextureFontImpl::RenderI(const T* string, const int len,
 {
 	FTPoint tmp;
 	
-	if (preRendered)
+	// Pages used from here on are newer than the ones before
+	atlas->Tick();
+	
+	// Distance field glyphs are laid out at the reference size
+	position = position * (1.0 / fieldScale);
+	spacing = spacing * (1.0 / fieldScale);
+	
+	if (preRendered || ftglesInCapture())
 	{
-		tmp = FTFontImpl::Render(string, len, position, spacing, renderMode);
+		tmp = RenderGlyphsI(string, len, position, spacing, renderMode);
+	}
+	else if (ftglesInSession())
+	{
+		// The alpha test applies to a whole draw, so draw the fields alone
+		if (fieldReference)
+		{
+			ftglesFlush();
+			ftglesAlphaTest(0.5f);
+		}
+		
+		tmp = RenderGlyphsI(string, len, position, spacing, renderMode);
+		
+		if (fieldReference)
+		{
+			ftglesFlush();
+			ftglesAlphaTest(0.0f);
+		}
 	}
 	else 
 	{
 		PreRender();
-		tmp = FTFontImpl::Render(string, len, position, spacing, renderMode);
+		tmp = RenderGlyphsI(string, len, position, spacing, renderMode);
 		PostRender();
 	}
-    return tmp;
+    return tmp * fieldScale;
 }
 
 
 void FTTextureFontImpl::PreRender() 
 {
-	disableTexture2D = false;
-	disableBlend = false;
-	GLfloat colors[4];
 	preRendered = true;
-	if (!glIsEnabled(GL_BLEND))
-	{
-		glEnable(GL_BLEND);
-		disableBlend = true;
-	}
-	else 
-	{
-		glGetIntegerv(GL_BLEND_SRC, &originalBlendSfactor);
-		glGetIntegerv(GL_BLEND_DST, &originalBlendDfactor);
-	}
-	
 	
-	if (!glIsEnabled(GL_TEXTURE_2D))
+	ftglesSaveTextState(&textState);
+	if (fieldReference)
 	{
-		glEnable(GL_TEXTURE_2D);
-		disableTexture2D = true;
+		ftglesAlphaTest(0.5f);
 	}
-	
-	// FTTextureGlyphImpl::ResetActiveTexture();
-	
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	
-	glGetFloatv(GL_CURRENT_COLOR, colors);
-	
-	ftglColor4f(colors[0], colors[1], colors[2], colors[3]);
+	ftglesLoadCurrentColor();
 	ftglBegin(GL_QUADS);
 }
 
@@ -289,19 +1264,7 @@ void FTTextureFontImpl::PostRender()
 	preRendered = false;
 	ftglEnd();
 	
-	if (disableBlend)
-	{
-		glDisable(GL_BLEND);
-	}
-	else
-	{
-		glBlendFunc(originalBlendSfactor, originalBlendDfactor);
-	}
-	
-	if (disableTexture2D)
-	{
-		glDisable(GL_TEXTURE_2D);
-	}
+	ftglesRestoreTextState(&textState);
 }
 
 
@@ -30,12 +30,18 @@
 #include "FTFontImpl.h"
 
 #include "FTVector.h"
+#include "FTDistanceField.h"
 
 class FTTextureGlyph;
+class FTTextureGlyphImpl;
+class FTAtlas;
+struct FTAtlasKey;
 
 class FTTextureFontImpl : public FTFontImpl
 {
     friend class FTTextureFont;
+    friend class FTTextureGlyphImpl;
+    friend class FTAtlas;
 
     protected:
         FTTextureFontImpl(FTFont *ftFont, const char* fontFilePath);
@@ -55,6 +61,84 @@ class FTTextureFontImpl : public FTFontImpl
         virtual bool FaceSize(const unsigned int size,
                               const unsigned int res = 72);
 
+        virtual unsigned int FaceSize() const;
+
+        /**
+         * Let go of the atlas entries of a size no longer kept.
+         */
+        virtual void ReleaseSize(const FTSize& size, FTGlyphContainer* glyphs);
+
+        /**
+         * Metrics, scaled from the reference size for distance fields.
+         */
+        virtual float Ascender() const;
+
+        virtual float Descender() const;
+
+        virtual float LineHeight() const;
+
+        virtual FTBBox BBox(const char *s, const int len, FTPoint, FTPoint);
+
+        virtual FTBBox BBox(const wchar_t *s, const int len, FTPoint, FTPoint);
+
+        virtual float Advance(const char *s, const int len, FTPoint);
+
+        virtual float Advance(const wchar_t *s, const int len, FTPoint);
+
+        /**
+         * Rasterise glyphs once at a reference size into distance fields,
+         * or at every face size if 0.
+         */
+        void DistanceField(unsigned int referenceSize);
+
+        /**
+         * Position glyphs to this many phases of a pixel, or 1 to snap
+         * them to whole pixels. Glyphs already made are unloaded.
+         */
+        void SubpixelPositions(unsigned int phases);
+
+        /**
+         * Write the glyphs made so far to a cache file, or take glyphs from
+         * one written for the same face, size and load flags.
+         */
+        bool SaveCache(const char* path);
+
+        bool LoadCache(const char* path);
+
+        /**
+         * The fraction of the texture pages' area taken up by glyphs.
+         */
+        float Occupancy() const;
+
+        /**
+         * Set the edge length of texture pages created from now on, or 0
+         * to size them from the face.
+         */
+        void PageSize(unsigned int size);
+
+        /**
+         * Set the most texture pages to keep, or 0 for no limit.
+         */
+        void PageBudget(unsigned int budget);
+
+        unsigned int PageCount() const;
+
+        /**
+         * Pack glyphs into a shared atlas, or the font's own if NULL.
+         * Glyphs already made are unloaded.
+         */
+        void SetAtlas(FTAtlas* shared);
+
+        /**
+         * Make glyphs ahead of time, uploading their bitmaps together
+         * rather than one glyph at a time.
+         */
+        virtual unsigned int Preload(const char *s, const int len);
+
+        virtual unsigned int Preload(const wchar_t *s, const int len);
+
+        virtual unsigned int Preload(unsigned int first, unsigned int last);
+
         virtual FTPoint Render(const char *s, const int len,
                                FTPoint position, FTPoint spacing,
                                int renderMode);
@@ -63,6 +147,8 @@ class FTTextureFontImpl : public FTFontImpl
                                FTPoint position, FTPoint spacing,
                                int renderMode);
 
+        virtual bool RendersQuads() const { return true; }
+
 	void PreRender();
 	
 	
@@ -83,16 +169,32 @@ class FTTextureFontImpl : public FTFontImpl
         inline void CalculateTextureSize();
 
         /**
-         * Creates a 'blank' OpenGL texture object.
-         *
-         * The format is GL_ALPHA and the params are
-         * GL_TEXTURE_WRAP_S = GL_CLAMP
-         * GL_TEXTURE_WRAP_T = GL_CLAMP
-         * GL_TEXTURE_MAG_FILTER = GL_LINEAR
-         * GL_TEXTURE_MIN_FILTER = GL_LINEAR
-         * Note that mipmapping is NOT used
+         * Unload a glyph, made for a character, whose atlas page has been
+         * evicted.
+         */
+        void Evicted(FTGlyph* glyph, unsigned int charCode);
+
+        /**
+         * Identify a bitmap of one of the face's glyphs at the current
+         * size.
+         */
+        FTAtlasKey GlyphKey(unsigned int index, unsigned int variant);
+
+        /**
+         * Give a glyph a variant per subpixel phase, the first being its
+         * whole pixel image, if subpixel positioning is on.
          */
-        inline GLuint CreateTexture();
+        void SetupVariants(FTTextureGlyph* glyph, unsigned int index);
+
+        /**
+         * Rasterise and pack a glyph's image for a subpixel phase.
+         */
+        void MakeVariant(FTTextureGlyphImpl* glyph, unsigned int phase);
+
+        /**
+         * Fill in a cache file header for the face as it is now.
+         */
+        void CacheHeader(void* header);
 
         /**
          * The maximum texture dimension on this OpenGL implemetation
@@ -109,11 +211,6 @@ class FTTextureFontImpl : public FTFontImpl
          */
         GLsizei textureHeight;
 
-        /**
-         *An array of texture ids
-         */
-        FTVector<GLuint> textureIDList;
-
         /**
          * The max height for glyphs in the current font
          */
@@ -140,25 +237,73 @@ class FTTextureFontImpl : public FTFontImpl
         unsigned int remGlyphs;
 
         /**
+         * The texture pages glyphs are packed into; the font's own, or one
+         * shared through an FTAtlasManager.
          */
-        int xOffset;
+        FTAtlas* atlas;
+        bool sharedAtlas;
 
         /**
+         * Identifies the face in atlas keys.
          */
-        int yOffset;
+        unsigned long faceKey;
+
+        /**
+         * Set while preloading or rendering, when new glyphs are only
+         * written to the atlas's copy of their page and uploaded at the end.
+         */
+        bool batchUploads;
+
+        /**
+         * The size distance field glyphs are rasterised at, or 0; the
+         * texels either side of the edge the field covers; and the face
+         * size over the reference size.
+         */
+        unsigned int fieldReference;
+        int fieldSpread;
+        float fieldScale;
+
+        /**
+         * Whether the face is set to the reference size.
+         */
+        bool fieldSized;
+
+        /**
+         * The size and resolution last asked for with FaceSize.
+         */
+        unsigned int faceSize;
+        unsigned int faceResolution;
+
+        /**
+         * Builds distance fields, and the field being built.
+         */
+        FTDistanceField field;
+        FTVector<unsigned char> fieldPixels;
+
+        /**
+         * The subpixel phases glyphs are positioned to, and the glyph
+         * MakeVariant is packing an image for. Its images are made again
+         * rather than the glyph unloaded if packing evicts one of them, as
+         * it is being drawn.
+         */
+        unsigned int subpixelPhases;
+        FTGlyph *variantGlyph;
 	
 	bool preRendered;
 	
-	bool disableTexture2D;
-	bool disableBlend;
-	GLint originalBlendSfactor;
-	GLint originalBlendDfactor;
+	ftglesTextState_t textState;
 	
 
         /* Internal generic Render() implementation */
         template <typename T>
         inline FTPoint RenderI(const T *s, const int len,
                                FTPoint position, FTPoint spacing, int mode);
+
+        /* Write the glyph quads into the open batch */
+        template <typename T>
+        inline FTPoint RenderGlyphsI(const T *s, const int len,
+                                     FTPoint position, FTPoint spacing,
+                                     int mode);
 };
 
 #endif // __FTTextureFontImpl__
@@ -0,0 +1,147 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __ftgl__
+#   warning Please use <FTGL/ftgles.h> instead of <FTAtlasManager.h>.
+#   include <FTGL/ftgles.h>
+#endif
+
+#ifndef __FTAtlasManager__
+#define __FTAtlasManager__
+
+#ifdef __cplusplus
+
+class FTAtlas;
+
+/**
+ * FTAtlasManager lets several FTTextureFont objects share texture pages.
+ *
+ * Glyph bitmaps from every registered font are packed into the same
+ * pages, keyed by face, size and glyph index, so a bitmap is stored once
+ * however many fonts use it. Text in different fonts and sizes then
+ * draws from one or two textures, and an FTTextSession batches it into
+ * one draw per page.
+ *
+ * Fonts keep a reference to the pages, so the manager may be destroyed
+ * before the fonts registered with it.
+ *
+ * @see FTTextureFont
+ */
+class FTGL_EXPORT FTAtlasManager
+{
+    public:
+        FTAtlasManager();
+
+        ~FTAtlasManager();
+
+        /**
+         * Set the width and height of pages created from now on. The size
+         * is rounded up to a power of two and limited to the largest
+         * texture the GL supports. By default a page is sized by the font
+         * that first needs it.
+         *
+         * @param size  The page edge length, or 0 for the default.
+         */
+        void PageSize(unsigned int size);
+
+        /**
+         * Limit the number of pages. Once reached, the least recently
+         * rendered page is emptied and reused, and its glyphs are unloaded
+         * from every font using them.
+         *
+         * @param pages  The most pages to keep, or 0 for no limit.
+         */
+        void PageBudget(unsigned int pages);
+
+        /**
+         * @return  The number of pages.
+         */
+        unsigned int PageCount() const;
+
+        /**
+         * @return  The fraction of the pages' area covered by glyph bitmaps
+         *          and their padding, from 0 to 1.
+         */
+        float Occupancy() const;
+
+    private:
+        friend class FTTextureFont;
+
+        /**
+         * The shared pages. For private use only.
+         */
+        FTAtlas *impl;
+};
+
+#endif //__cplusplus
+
+FTGL_BEGIN_C_DECLS
+
+/**
+ * FTGLatlas shares texture pages between texture fonts.
+ */
+struct _FTGLatlas;
+typedef struct _FTGLatlas FTGLatlas;
+
+/**
+ * Create an atlas manager.
+ *
+ * @return  An FTGLatlas* object.
+ */
+FTGL_EXPORT FTGLatlas *ftglCreateAtlasManager(void);
+
+/**
+ * Destroy an atlas manager.
+ *
+ * @param atlas  An FTGLatlas* object.
+ */
+FTGL_EXPORT void ftglDestroyAtlasManager(FTGLatlas* atlas);
+
+/**
+ * Set the page size of an atlas manager.
+ *
+ * @param atlas  An FTGLatlas* object.
+ * @param size  The page edge length, or 0 for the default.
+ */
+FTGL_EXPORT void ftglSetAtlasPageSize(FTGLatlas* atlas, unsigned int size);
+
+/**
+ * Limit the number of pages of an atlas manager.
+ *
+ * @param atlas  An FTGLatlas* object.
+ * @param pages  The most pages to keep, or 0 for no limit.
+ */
+FTGL_EXPORT void ftglSetAtlasPageBudget(FTGLatlas* atlas, unsigned int pages);
+
+/**
+ * Pack a texture font's glyphs into an atlas manager's pages.
+ *
+ * @param font  An FTGLfont* object created with ftglCreateTextureFont.
+ * @param atlas  An FTGLatlas* object, or NULL for the font's own pages.
+ */
+FTGL_EXPORT void ftglSetFontAtlasManager(FTGLfont* font, FTGLatlas* atlas);
+
+FTGL_END_C_DECLS
+
+#endif  //  __FTAtlasManager__
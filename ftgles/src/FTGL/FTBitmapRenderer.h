@@ -0,0 +1,269 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __ftgl__
+#   warning Please use <FTGL/ftgles.h> instead of <FTBitmapRenderer.h>.
+#   include <FTGL/ftgles.h>
+#endif
+
+#ifndef __FTBitmapRenderer__
+#define __FTBitmapRenderer__
+
+#ifdef __cplusplus
+
+class FTBitmapRendererImpl;
+class FTLayout;
+
+/**
+ * FTBitmapRenderer rasterises text into memory the caller owns, without
+ * OpenGL, for making text images on machines with no GPU or display.
+ *
+ * Glyphs are loaded with the same flags as FTBufferFont, so text has the
+ * metrics and shapes it has on device. Coordinates are in pixels with y
+ * up from the bottom of the target, as with the GL fonts; the target's
+ * rows are stored top first.
+ *
+ * A renderer has its own face and glyphs, so renderers may be used from
+ * several threads at once as long as each is only used by one thread at
+ * a time.
+ *
+ * @see FTBuffer
+ * @see FTBufferGlyph
+ */
+class FTGL_EXPORT FTBitmapRenderer
+{
+    public:
+        /**
+         * Open and read a font file. Sets Error flag.
+         *
+         * @param fontFilePath  font file path.
+         */
+        FTBitmapRenderer(const char* fontFilePath);
+
+        /**
+         * Open and read a font from a buffer in memory. Sets Error flag.
+         * The buffer is owned by the client and is NOT copied by FTGL. The
+         * pointer must be valid while using FTGL.
+         *
+         * @param pBufferBytes  the in-memory buffer
+         * @param bufferSizeInBytes  the length of the buffer in bytes
+         */
+        FTBitmapRenderer(const unsigned char *pBufferBytes,
+                         size_t bufferSizeInBytes);
+
+        /**
+         * Destructor
+         */
+        ~FTBitmapRenderer();
+
+        /**
+         * Queries the renderer for errors.
+         *
+         * @return  The current error code.
+         */
+        FT_Error Error() const;
+
+        /**
+         * The font text is rasterised with. Use it to set the face size
+         * and char map, to measure text, and as the font of layouts
+         * passed to Render. Rendering with it directly draws nothing.
+         *
+         * @return  The renderer's font, owned by the renderer.
+         */
+        FTFont* Font();
+
+        /**
+         * Set the memory text is rendered into. Text is composited over
+         * what is there: A8 targets keep the higher coverage, RGBA8
+         * targets have the colour blended over them.
+         *
+         * @param pixels  The top row of the target.
+         * @param width  Target width in pixels.
+         * @param height  Target height in pixels.
+         * @param stride  Bytes from one row to the next.
+         * @param format  FTGL::PIXEL_A8 coverage or FTGL::PIXEL_RGBA8
+         *                non-premultiplied colour.
+         */
+        void Target(void* pixels, int width, int height, int stride,
+                    FTGL::PixelFormat format = FTGL::PIXEL_A8);
+
+        /**
+         * Set the colour text is rendered in on RGBA8 targets. The
+         * default is opaque white.
+         */
+        void Color(unsigned char red, unsigned char green,
+                   unsigned char blue, unsigned char alpha = 255);
+
+        /**
+         * Render a string of characters into the target.
+         *
+         * @param string  'C' style string to be output.
+         * @param len  The length of the string, or -1 for all of it.
+         * @param position  The pen position of the first character.
+         * @param spacing  A displacement vector to add after each character
+         *                 has been checked (optional).
+         * @return  The new pen position after the last character was
+         *          output.
+         */
+        FTPoint Render(const char* string, const int len = -1,
+                       FTPoint position = FTPoint(),
+                       FTPoint spacing = FTPoint());
+
+        /**
+         * Render a string of characters into the target.
+         *
+         * @param string  wchar_t string to be output.
+         * @param len  The length of the string, or -1 for all of it.
+         * @param position  The pen position of the first character.
+         * @param spacing  A displacement vector to add after each character
+         *                 has been checked (optional).
+         * @return  The new pen position after the last character was
+         *          output.
+         */
+        FTPoint Render(const wchar_t* string, const int len = -1,
+                       FTPoint position = FTPoint(),
+                       FTPoint spacing = FTPoint());
+
+        /**
+         * Render a string laid out by a layout into the target. The
+         * layout's font must be Font().
+         *
+         * @param layout  The layout, such as an FTSimpleLayout.
+         * @param string  'C' style string to be output.
+         * @param len  The length of the string, or -1 for all of it.
+         * @param position  Where the layout's origin is placed.
+         */
+        void Render(FTLayout& layout, const char* string, const int len = -1,
+                    FTPoint position = FTPoint());
+
+        /**
+         * Render a string laid out by a layout into the target. The
+         * layout's font must be Font().
+         *
+         * @param layout  The layout, such as an FTSimpleLayout.
+         * @param string  wchar_t string to be output.
+         * @param len  The length of the string, or -1 for all of it.
+         * @param position  Where the layout's origin is placed.
+         */
+        void Render(FTLayout& layout, const wchar_t* string,
+                    const int len = -1, FTPoint position = FTPoint());
+
+    private:
+        /**
+         * Internal FTGL FTBitmapRenderer implementation object. For private
+         * use only.
+         */
+        FTBitmapRendererImpl *impl;
+};
+
+#endif //__cplusplus
+
+FTGL_BEGIN_C_DECLS
+
+/**
+ * FTGLbitmaprenderer rasterises text into memory without OpenGL.
+ */
+struct _FTGLbitmaprenderer;
+typedef struct _FTGLbitmaprenderer FTGLbitmaprenderer;
+
+/**
+ * Create a bitmap renderer.
+ *
+ * @param file  The font file name.
+ * @return  An FTGLbitmaprenderer* object, or NULL if the font could not
+ *          be opened.
+ */
+FTGL_EXPORT FTGLbitmaprenderer *ftglCreateBitmapRenderer(const char *file);
+
+/**
+ * Destroy a bitmap renderer.
+ *
+ * @param renderer  An FTGLbitmaprenderer* object.
+ */
+FTGL_EXPORT void ftglDestroyBitmapRenderer(FTGLbitmaprenderer* renderer);
+
+/**
+ * Get the font a bitmap renderer rasterises with, to size it, measure
+ * text or lay text out with. It belongs to the renderer and must not be
+ * destroyed.
+ *
+ * @param renderer  An FTGLbitmaprenderer* object.
+ * @return  An FTGLfont* object.
+ */
+FTGL_EXPORT FTGLfont *ftglGetBitmapRendererFont(FTGLbitmaprenderer* renderer);
+
+/**
+ * Set the memory a bitmap renderer renders into.
+ *
+ * @param renderer  An FTGLbitmaprenderer* object.
+ * @param pixels  The top row of the target.
+ * @param width  Target width in pixels.
+ * @param height  Target height in pixels.
+ * @param stride  Bytes from one row to the next.
+ * @param format  FTGL_PIXEL_A8 or FTGL_PIXEL_RGBA8.
+ */
+FTGL_EXPORT void ftglSetBitmapRendererTarget(FTGLbitmaprenderer* renderer,
+                                             void* pixels, int width,
+                                             int height, int stride,
+                                             int format);
+
+/**
+ * Set the colour a bitmap renderer renders in on RGBA8 targets.
+ *
+ * @param renderer  An FTGLbitmaprenderer* object.
+ */
+FTGL_EXPORT void ftglSetBitmapRendererColor(FTGLbitmaprenderer* renderer,
+                                            unsigned char red,
+                                            unsigned char green,
+                                            unsigned char blue,
+                                            unsigned char alpha);
+
+/**
+ * Render a string into a bitmap renderer's target.
+ *
+ * @param renderer  An FTGLbitmaprenderer* object.
+ * @param string  A char string.
+ * @param x  The pen position of the first character.
+ * @param y  The pen position of the first character.
+ */
+FTGL_EXPORT void ftglRenderBitmapText(FTGLbitmaprenderer* renderer,
+                                      const char *string, float x, float y);
+
+/**
+ * Render a string laid out by a layout into a bitmap renderer's target.
+ * The layout's font must be the renderer's.
+ *
+ * @param renderer  An FTGLbitmaprenderer* object.
+ * @param layout  An FTGLlayout* object.
+ * @param string  A char string.
+ * @param x  Where the layout's origin is placed.
+ * @param y  Where the layout's origin is placed.
+ */
+FTGL_EXPORT void ftglRenderBitmapLayout(FTGLbitmaprenderer* renderer,
+                                        FTGLlayout* layout,
+                                        const char *string, float x, float y);
+
+FTGL_END_C_DECLS
+
+#endif  //  __FTBitmapRenderer__
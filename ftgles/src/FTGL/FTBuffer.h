@@ -76,13 +76,28 @@ class FTGL_EXPORT FTBuffer
         }
 
         /**
-         * Set the buffer's size.
+         * Set the buffer's size, leaving it cleared. Only the region
+         * written since the last call is cleared, and memory is kept for
+         * the largest size asked for, so a buffer resized for every
+         * string costs about as much as the glyphs drawn into it.
          *
          * @param w  The buffer's desired width, in pixels.
          * @param h  The buffer's desired height, in pixels.
          */
         void Size(int w, int h);
 
+        /**
+         * Mark a region of the buffer as written, so the next Size() call
+         * clears it. Glyphs mark what they draw; anything else writing to
+         * Pixels() must mark it too.
+         *
+         * @param x  The region's left edge, in pixels.
+         * @param y  The region's top row, in pixels.
+         * @param w  The region's width, in pixels.
+         * @param h  The region's height, in pixels.
+         */
+        void Dirty(int x, int y, int w, int h);
+
         /**
          * Get the buffer's width.
          *
@@ -111,9 +126,16 @@ class FTGL_EXPORT FTBuffer
         int width, height;
 
         /**
-         * Buffer's pixel buffer.
+         * Buffer's pixel buffer, and the number of pixels allocated.
          */
         unsigned char *pixels;
+        int capacity;
+
+        /**
+         * The bounds of the region written since the buffer was last
+         * cleared. Everything outside it is zero.
+         */
+        int dirtyLeft, dirtyTop, dirtyRight, dirtyBottom;
 
         /**
          * Buffer's internal pen position.
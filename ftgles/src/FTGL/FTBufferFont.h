@@ -66,6 +66,23 @@ class FTGL_EXPORT FTBufferFont : public FTFont
          */
         ~FTBufferFont();
 
+        /**
+         * Limit the strings whose bitmaps are kept for rendering again.
+         * Bitmaps are packed together into 512 by 512 texture pages, so
+         * labels drawn in a session share a texture and a batch. When a
+         * new string would go over either limit, the least recently
+         * rendered strings are dropped first. Strings are told apart by
+         * their characters, spacing and render mode. By default 64
+         * strings are kept, with no limit on their size.
+         *
+         * @param strings  The most strings to keep, or 0 for no limit.
+         * @param bytes  The most bytes of bitmaps and string copies to
+         *               keep, or 0 for no limit. Pages are limited to
+         *               what this covers, at least one. A string larger
+         *               than this is still drawn, on its own.
+         */
+        void CacheSize(unsigned int strings, size_t bytes = 0);
+
     protected:
         /**
          * Construct a glyph of the correct type.
@@ -93,6 +110,16 @@ FTGL_BEGIN_C_DECLS
  */
 FTGL_EXPORT FTGLfont *ftglCreateBufferFont(const char *file);
 
+/**
+ * Limit the strings a buffer font keeps textures for.
+ *
+ * @param font  An FTGLfont* object created with ftglCreateBufferFont.
+ * @param strings  The most strings to keep, or 0 for no limit.
+ * @param bytes  The most bytes to keep, or 0 for no limit.
+ */
+FTGL_EXPORT void ftglSetBufferFontCache(FTGLfont* font, unsigned int strings,
+                                        size_t bytes);
+
 FTGL_END_C_DECLS
 
 #endif  //  __FTBufferFont__
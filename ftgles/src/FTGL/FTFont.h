@@ -33,9 +33,25 @@
 #ifndef __FTFont__
 #define __FTFont__
 
+FTGL_BEGIN_C_DECLS
+
+/**
+ * A colour run. Characters from start up to the start of the next run are
+ * drawn in rgba. start counts characters, not bytes, from the beginning
+ * of the string; runs must be sorted by start.
+ */
+typedef struct
+{
+    unsigned int start;
+    unsigned char rgba[4];
+} FTGLcolorrun;
+
+FTGL_END_C_DECLS
+
 #ifdef __cplusplus
 
 class FTFontImpl;
+class FTQuadSink;
 
 /**
  * FTFont is the public interface for the FTGL library.
@@ -83,6 +99,9 @@ class FTGL_EXPORT FTFont
         friend class FTPolygonFont;
         friend class FTTextureFont;
 
+        /* Allow recorded text to check the font for changes */
+        friend class FTTextBlockImpl;
+
         /**
          * Internal FTGL FTFont constructor. For private use only.
          *
@@ -167,6 +186,15 @@ class FTGL_EXPORT FTFont
          */
         virtual unsigned int FaceSize() const;
 
+        /**
+         * Set how many face sizes to keep glyphs for. Setting a size whose
+         * glyphs are kept makes nothing again; setting another once the
+         * limit is reached unloads the least recently set size's glyphs.
+         *
+         * @param count  The number of sizes, at least 1. The default is 4.
+         */
+        virtual void CachedSizes(unsigned int count);
+
         /**
          * Set the extrusion distance for the font. Only implemented by
          * FTExtrudeFont
@@ -319,6 +347,36 @@ class FTGL_EXPORT FTFont
         virtual float Advance(const wchar_t* string, const int len = -1,
                               FTPoint spacing = FTPoint());
 
+        /**
+         * Make the glyphs for every character of a string ahead of time,
+         * so a later Render() does not stop to load, rasterise and upload
+         * them. Call it while loading rather than mid-animation.
+         *
+         * @param string  'C' style string of the characters to load.
+         * @return  The number of glyphs made; characters already loaded
+         *          are not counted.
+         */
+        virtual unsigned int Preload(const char* string);
+
+        /**
+         * Make the glyphs for every character of a string ahead of time.
+         *
+         * @param string  A wchar_t string of the characters to load.
+         * @return  The number of glyphs made.
+         */
+        virtual unsigned int Preload(const wchar_t* string);
+
+        /**
+         * Make the glyphs for a range of characters ahead of time.
+         * Characters the face does not map are skipped, so a range may
+         * span a whole Unicode block.
+         *
+         * @param first  The first character code to load.
+         * @param last  The last character code to load, inclusive.
+         * @return  The number of glyphs made.
+         */
+        virtual unsigned int Preload(unsigned int first, unsigned int last);
+
         /**
          * Render a string of characters.
          *
@@ -355,6 +413,98 @@ class FTGL_EXPORT FTFont
                                FTPoint spacing = FTPoint(),
                                int renderMode = FTGL::RENDER_ALL);
 
+        /**
+         * Render a string of characters into a sink instead of drawing it.
+         * No drawing or GL state calls are made; the sink receives the
+         * positioned glyph quads, in the colour set with ftglColor4f, so
+         * they can be merged into another batch. Textures for new glyphs
+         * are still created through the glue backend. Only fonts that
+         * render quads, FTTextureFont and FTBufferFont, produce output;
+         * other fonts render nothing and return the pen unchanged.
+         *
+         * @param string  'C' style string to be output.
+         * @param sink  Receives the quads.
+         * @param len  The length of the string. If < 0 then all characters
+         *             will be output until a null character is encountered
+         *             (optional).
+         * @param position  The pen position of the first character (optional).
+         * @param spacing  A displacement vector to add after each character
+         *                 has been output (optional).
+         * @return  The new pen position after the last character was output.
+         */
+        virtual FTPoint Render(const char* string, FTQuadSink& sink,
+                               const int len = -1,
+                               FTPoint position = FTPoint(),
+                               FTPoint spacing = FTPoint());
+
+        /**
+         * Render a string of characters into a sink instead of drawing it.
+         * Fonts that do not render quads return the pen unchanged.
+         *
+         * @param string  wchar_t string to be output.
+         * @param sink  Receives the quads.
+         * @param len  The length of the string. If < 0 then all characters
+         *             will be output until a null character is encountered
+         *             (optional).
+         * @param position  The pen position of the first character (optional).
+         * @param spacing  A displacement vector to add after each character
+         *                 has been output (optional).
+         * @return  The new pen position after the last character was output.
+         */
+        virtual FTPoint Render(const wchar_t* string, FTQuadSink& sink,
+                               const int len = -1,
+                               FTPoint position = FTPoint(),
+                               FTPoint spacing = FTPoint());
+
+        /**
+         * Render a string of characters in several colours. The colours
+         * are written per vertex, so the whole string is still a single
+         * batch. Characters before the first run use the current colour.
+         * Only fonts that colour each glyph's vertices, FTTextureFont,
+         * FTPolygonFont and FTOutlineFont, honour the runs; FTBufferFont
+         * draws the string in the current colour.
+         *
+         * @param string  'C' style string to be output.
+         * @param runs  Colour runs, sorted by start.
+         * @param runCount  The number of runs.
+         * @param len  The length of the string. If < 0 then all characters
+         *             will be displayed until a null character is encountered
+         *             (optional).
+         * @param position  The pen position of the first character (optional).
+         * @param spacing  A displacement vector to add after each character
+         *                 has been displayed (optional).
+         * @param renderMode  Render mode to use for display (optional).
+         * @return  The new pen position after the last character was output.
+         */
+        virtual FTPoint Render(const char* string,
+                               const FTGL::FTGLcolorrun* runs,
+                               unsigned int runCount, const int len = -1,
+                               FTPoint position = FTPoint(),
+                               FTPoint spacing = FTPoint(),
+                               int renderMode = FTGL::RENDER_ALL);
+
+        /**
+         * Render a string of characters in several colours.
+         *
+         * @param string  wchar_t string to be output.
+         * @param runs  Colour runs, sorted by start.
+         * @param runCount  The number of runs.
+         * @param len  The length of the string. If < 0 then all characters
+         *             will be displayed until a null character is encountered
+         *             (optional).
+         * @param position  The pen position of the first character (optional).
+         * @param spacing  A displacement vector to add after each character
+         *                 has been displayed (optional).
+         * @param renderMode  Render mode to use for display (optional).
+         * @return  The new pen position after the last character was output.
+         */
+        virtual FTPoint Render(const wchar_t* string,
+                               const FTGL::FTGLcolorrun* runs,
+                               unsigned int runCount, const int len = -1,
+                               FTPoint position = FTPoint(),
+                               FTPoint spacing = FTPoint(),
+                               int renderMode = FTGL::RENDER_ALL);
+
 	
 	virtual void PreRender();
 	
@@ -493,6 +643,14 @@ FTGL_EXPORT int ftglSetFontFaceSize(FTGLfont* font, unsigned int size,
  */
 FTGL_EXPORT unsigned int ftglGetFontFaceSize(FTGLfont* font);
 
+/**
+ * Set how many face sizes to keep glyphs for.
+ *
+ * @param font  An FTGLfont* object.
+ * @param count  The number of sizes, at least 1.
+ */
+FTGL_EXPORT void ftglSetFontCachedSizes(FTGLfont* font, unsigned int count);
+
 /**
  * Set the extrusion distance for the font. Only implemented by
  * FTExtrudeFont.
@@ -568,6 +726,28 @@ FTGL_EXPORT void ftglGetFontBBox(FTGLfont* font, const char *string,
  */
 FTGL_EXPORT float ftglGetFontAdvance(FTGLfont* font, const char *string);
 
+/**
+ * Make the glyphs for every character of a string ahead of time.
+ *
+ * @param font  An FTGLfont* object.
+ * @param string  A char string of the characters to load.
+ * @return  The number of glyphs made.
+ */
+FTGL_EXPORT unsigned int ftglPreloadFont(FTGLfont* font, const char *string);
+
+/**
+ * Make the glyphs for a range of characters ahead of time. Characters the
+ * face does not map are skipped.
+ *
+ * @param font  An FTGLfont* object.
+ * @param first  The first character code to load.
+ * @param last  The last character code to load, inclusive.
+ * @return  The number of glyphs made.
+ */
+FTGL_EXPORT unsigned int ftglPreloadFontRange(FTGLfont* font,
+                                              unsigned int first,
+                                              unsigned int last);
+
 /**
  * Render a string of characters.
  *
@@ -577,6 +757,19 @@ FTGL_EXPORT float ftglGetFontAdvance(FTGLfont* font, const char *string);
  */
 FTGL_EXPORT void ftglRenderFont(FTGLfont* font, const char *string, int mode);
 
+/**
+ * Render a string of characters in several colours, as one batch.
+ *
+ * @param font  An FTGLfont* object.
+ * @param string  Char string to be output.
+ * @param runs  Colour runs, sorted by start.
+ * @param count  The number of runs.
+ * @param mode  Render mode to display.
+ */
+FTGL_EXPORT void ftglRenderFontRuns(FTGLfont* font, const char *string,
+                                    const FTGLcolorrun *runs,
+                                    unsigned int count, int mode);
+
 /**
  * Query a font for errors.
  *
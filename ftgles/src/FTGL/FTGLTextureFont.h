@@ -68,6 +68,108 @@ class  FTGL_EXPORT FTTextureFont : public FTFont
          */
         virtual ~FTTextureFont();
 
+        /**
+         * Measure how densely glyphs are packed into the font's texture
+         * pages.
+         *
+         * @return  The fraction of the pages' area covered by glyph
+         *          bitmaps and their padding, from 0 to 1.
+         */
+        float Occupancy() const;
+
+        /**
+         * Set the width and height of texture pages created from now on.
+         * The size is rounded up to a power of two and limited to the
+         * largest texture the GL supports. By default pages are sized
+         * from the face.
+         *
+         * @param size  The page edge length, or 0 for the default.
+         */
+        void PageSize(unsigned int size);
+
+        /**
+         * Limit the number of texture pages. When a glyph does not fit and
+         * the limit is reached, the least recently rendered page is
+         * emptied and reused; its glyphs are made again when next needed.
+         * Text drawn earlier in a session is flushed first, but quads
+         * already captured by an FTTextBlock or FTQuadSink may then show
+         * the wrong glyphs; text blocks rebuild on their next render.
+         *
+         * @param pages  The most pages to keep, or 0 for no limit.
+         */
+        void PageBudget(unsigned int pages);
+
+        /**
+         * @return  The number of texture pages the font holds.
+         */
+        unsigned int PageCount() const;
+
+        /**
+         * Pack glyphs into pages shared with other fonts through an
+         * FTAtlasManager, or back into the font's own pages. Glyphs
+         * already made are unloaded and made again when next needed. The
+         * font's page size and budget then apply to the shared pages.
+         *
+         * @param manager  The atlas manager, or NULL for the font's own
+         *                 pages.
+         */
+        void AtlasManager(FTAtlasManager* manager);
+
+        /**
+         * Draw glyphs from signed distance fields rather than coverage
+         * bitmaps. Each glyph is rasterised once at the reference size
+         * and FaceSize() only rescales it, so a size that changes every
+         * frame makes no new glyphs. Metrics are the reference size's,
+         * scaled.
+         *
+         * GLES 1 has no shaders, so the field is cut at 0.5 with the alpha
+         * test: edges stay sharp at any size but are not antialiased.
+         * Inside a session the font's text is drawn on its own around the
+         * alpha test; quads captured by an FTTextBlock or FTQuadSink are
+         * drawn with whatever alpha test is set when they are replayed.
+         *
+         * @param referenceSize  The size in points glyphs are rasterised
+         *                       at, or 0 to rasterise at every face size.
+         */
+        void DistanceField(unsigned int referenceSize);
+
+        /**
+         * Position glyphs to a fraction of a pixel instead of snapping
+         * them to whole pixels, so kerned, justified or scrolling text
+         * keeps even spacing. Each glyph gets an image per phase, made
+         * the first time it lands on that phase and packed alongside the
+         * others.
+         *
+         * Distance field glyphs are never snapped, so this has no effect
+         * on them. Glyphs already made are unloaded.
+         *
+         * @param phases  The phases a pixel is divided into, up to 64, or
+         *                1 to snap to whole pixels (the default).
+         */
+        void SubpixelPositions(unsigned int phases);
+
+        /**
+         * Write the glyphs made so far, with their texture pages, to a
+         * cache file that LoadCache can read back instead of rasterising.
+         * The file is only good for this face at this size with these
+         * glyph load flags, on a machine of the same byte order.
+         *
+         * @param path  The file to write.
+         * @return  <code>true</code> if the file was written.
+         */
+        bool SaveCache(const char* path);
+
+        /**
+         * Take glyphs from a file written by SaveCache. The file is mapped
+         * rather than read, and its pages uploaded as they are. Set the
+         * face size first; a file written for another face, size or
+         * format is refused. Glyphs the font already has are kept.
+         *
+         * @param path  The file to read.
+         * @return  <code>true</code> if the file matched and was loaded.
+         */
+        bool LoadCache(const char* path);
+
     protected:
         /**
          * Construct a glyph of the correct type.
@@ -97,6 +199,45 @@ FTGL_BEGIN_C_DECLS
  */
 FTGL_EXPORT FTGLfont *ftglCreateTextureFont(const char *file);
 
+/**
+ * Draw a texture font's glyphs from signed distance fields.
+ *
+ * @param font  An FTGLfont* object created with ftglCreateTextureFont.
+ * @param referenceSize  The size in points glyphs are rasterised at, or 0
+ *                       to rasterise at every face size.
+ */
+FTGL_EXPORT void ftglSetFontDistanceField(FTGLfont* font,
+                                          unsigned int referenceSize);
+
+/**
+ * Position a texture font's glyphs to a fraction of a pixel.
+ *
+ * @param font  An FTGLfont* object created with ftglCreateTextureFont.
+ * @param phases  The phases a pixel is divided into, or 1 to snap to
+ *                whole pixels.
+ */
+FTGL_EXPORT void ftglSetFontSubpixelPositions(FTGLfont* font,
+                                              unsigned int phases);
+
+/**
+ * Write a texture font's glyphs to a cache file.
+ *
+ * @param font  An FTGLfont* object created with ftglCreateTextureFont.
+ * @param path  The file to write.
+ * @return  1 if the file was written, 0 otherwise.
+ */
+FTGL_EXPORT int ftglSaveFontCache(FTGLfont* font, const char* path);
+
+/**
+ * Load a texture font's glyphs from a cache file written at the same face
+ * size.
+ *
+ * @param font  An FTGLfont* object created with ftglCreateTextureFont.
+ * @param path  The file to read.
+ * @return  1 if the file matched and was loaded, 0 otherwise.
+ */
+FTGL_EXPORT int ftglLoadFontCache(FTGLfont* font, const char* path);
+
 FTGL_END_C_DECLS
 
 #endif // __FTTextureFont__
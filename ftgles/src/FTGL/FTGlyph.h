@@ -74,6 +74,9 @@ class FTGL_EXPORT FTGlyph
         friend class FTPolygonGlyph;
         friend class FTTextureGlyph;
 
+        /* Allow the texture font to track its glyphs' texture pages */
+        friend class FTTextureFontImpl;
+
     public:
         /**
           * Destructor
@@ -0,0 +1,157 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __ftgl__
+#   warning Please use <FTGL/ftgles.h> instead of <FTQuadSink.h>.
+#   include <FTGL/ftgles.h>
+#endif
+
+#ifndef __FTQuadSink__
+#define __FTQuadSink__
+
+FTGL_BEGIN_C_DECLS
+
+/**
+ * A positioned, textured glyph quad. The first corner is the top left of
+ * the glyph and the second its bottom right, each with its texture
+ * coordinates. page is the texture the quad samples from.
+ */
+typedef struct
+{
+    float x0, y0, s0, t0;
+    float x1, y1, s1, t1;
+    unsigned char rgba[4];
+    unsigned int page;
+} FTGLquad;
+
+FTGL_END_C_DECLS
+
+#ifdef __cplusplus
+
+
+/**
+ * FTQuadSink receives the glyph quads of a string rendered with
+ * FTFont::Render(string, sink), in place of drawing them.
+ *
+ * @see FTFont
+ */
+class FTGL_EXPORT FTQuadSink
+{
+    public:
+        virtual ~FTQuadSink();
+
+        /**
+         * Receive the next quads of the string, in order. May be called
+         * more than once per string.
+         *
+         * @param quads  The quads.
+         * @param count  The number of quads.
+         */
+        virtual void Quads(const FTGL::FTGLquad* quads, unsigned int count) = 0;
+};
+
+
+/**
+ * FTQuadBuffer is a sink that writes into a caller supplied array.
+ *
+ * Quads that do not fit are counted but dropped, so a caller can size the
+ * array from Needed() and render again.
+ */
+class FTGL_EXPORT FTQuadBuffer : public FTQuadSink
+{
+    public:
+        /**
+         * @param quads  The array to write to.
+         * @param capacity  The number of quads the array holds.
+         */
+        FTQuadBuffer(FTGL::FTGLquad* quads, unsigned int capacity);
+
+        virtual void Quads(const FTGL::FTGLquad* quads, unsigned int count);
+
+        /**
+         * @return  The number of quads written to the array.
+         */
+        unsigned int Count() const;
+
+        /**
+         * @return  The number of quads rendered, including dropped ones.
+         */
+        unsigned int Needed() const;
+
+        /**
+         * Start writing at the beginning of the array again.
+         */
+        void Reset();
+
+    private:
+        FTGL::FTGLquad* buffer;
+        unsigned int capacity;
+        unsigned int needed;
+};
+
+#endif //__cplusplus
+
+FTGL_BEGIN_C_DECLS
+
+/**
+ * Receives the glyph quads of ftglRenderFontToCallback.
+ */
+typedef void (*FTGLquadCallback)(const FTGLquad* quads, unsigned int count,
+                                 void* data);
+
+/**
+ * Render a string into an array of quads instead of drawing it.
+ *
+ * @param font  An FTGLfont* object.
+ * @param string  A char string.
+ * @param x  The pen position of the first character.
+ * @param y  The pen position of the first character.
+ * @param quads  The array to write to.
+ * @param capacity  The number of quads the array holds.
+ * @return  The number of quads rendered, which may exceed capacity.
+ */
+FTGL_EXPORT unsigned int ftglRenderFontToQuads(FTGLfont* font,
+                                               const char *string,
+                                               float x, float y,
+                                               FTGLquad* quads,
+                                               unsigned int capacity);
+
+/**
+ * Render a string by passing its quads to a callback instead of drawing it.
+ *
+ * @param font  An FTGLfont* object.
+ * @param string  A char string.
+ * @param x  The pen position of the first character.
+ * @param y  The pen position of the first character.
+ * @param callback  The function to receive the quads.
+ * @param data  Passed through to the callback.
+ */
+FTGL_EXPORT void ftglRenderFontToCallback(FTGLfont* font, const char *string,
+                                          float x, float y,
+                                          FTGLquadCallback callback,
+                                          void* data);
+
+FTGL_END_C_DECLS
+
+#endif  //  __FTQuadSink__
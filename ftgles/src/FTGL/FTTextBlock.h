@@ -0,0 +1,179 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __ftgl__
+#   warning Please use <FTGL/ftgles.h> instead of <FTTextBlock.h>.
+#   include <FTGL/ftgles.h>
+#endif
+
+#ifndef __FTTextBlock__
+#define __FTTextBlock__
+
+#ifdef __cplusplus
+
+class FTTextBlockImpl;
+
+/**
+ * FTTextBlock records the quads of a string once and replays them.
+ *
+ * The first Render() lays the string out with its font and keeps the
+ * resulting vertices. Later calls copy them, translated to the new pen
+ * position, straight into the current batch, skipping character lookup,
+ * kerning and glyph dispatch. The block is rebuilt when its text or font
+ * changes, or when the font is resized.
+ *
+ * Only quad output is recorded, which covers FTTextureFont and
+ * FTBufferFont; a block of any other font stays empty, drawing nothing
+ * and leaving the pen where it was. Text is drawn in the current colour.
+ *
+ * @see FTFont
+ * @see FTTextSession
+ */
+class FTGL_EXPORT FTTextBlock
+{
+    public:
+        /**
+         * Create an empty block.
+         *
+         * @param font  The font to lay the text out with.
+         */
+        FTTextBlock(FTFont* font = 0);
+
+        /**
+         * Create a block holding a string.
+         *
+         * @param font  The font to lay the text out with.
+         * @param text  A char string.
+         */
+        FTTextBlock(FTFont* font, const char* text);
+
+        /**
+         * Destructor.
+         */
+        ~FTTextBlock();
+
+        /**
+         * Change the font.
+         *
+         * @param font  The font to lay the text out with.
+         */
+        void SetFont(FTFont* font);
+
+        /**
+         * Get the font.
+         *
+         * @return  The current font.
+         */
+        FTFont* GetFont() const;
+
+        /**
+         * Change the text.
+         *
+         * @param text  A char string.
+         */
+        void SetText(const char* text);
+
+        /**
+         * Change the text.
+         *
+         * @param text  A wchar_t string.
+         */
+        void SetText(const wchar_t* text);
+
+        /**
+         * Render the block.
+         *
+         * @param position  The pen position of the first character.
+         * @return  The new pen position after the last character.
+         */
+        FTPoint Render(FTPoint position = FTPoint());
+
+        /**
+         * The distance the pen moves over the whole block.
+         *
+         * @return  The advance of the text.
+         */
+        FTPoint Advance();
+
+    private:
+        /**
+         * Internal FTGL FTTextBlock implementation object. For private use
+         * only.
+         */
+        FTTextBlockImpl *impl;
+};
+
+#endif //__cplusplus
+
+FTGL_BEGIN_C_DECLS
+
+/**
+ * FTGLtextblock records the quads of a string once and replays them.
+ */
+struct _FTGLtextblock;
+typedef struct _FTGLtextblock FTGLtextblock;
+
+/**
+ * Create a text block.
+ *
+ * @param font  An FTGLfont* object to lay the text out with.
+ * @return  An FTGLtextblock* object.
+ */
+FTGL_EXPORT FTGLtextblock *ftglCreateTextBlock(FTGLfont* font);
+
+/**
+ * Destroy a text block.
+ *
+ * @param block  An FTGLtextblock* object.
+ */
+FTGL_EXPORT void ftglDestroyTextBlock(FTGLtextblock* block);
+
+/**
+ * Change the font of a text block.
+ *
+ * @param block  An FTGLtextblock* object.
+ * @param font  An FTGLfont* object.
+ */
+FTGL_EXPORT void ftglSetTextBlockFont(FTGLtextblock* block, FTGLfont* font);
+
+/**
+ * Change the text of a text block.
+ *
+ * @param block  An FTGLtextblock* object.
+ * @param text  A char string.
+ */
+FTGL_EXPORT void ftglSetTextBlockText(FTGLtextblock* block, const char *text);
+
+/**
+ * Render a text block.
+ *
+ * @param block  An FTGLtextblock* object.
+ * @param x  The pen position of the first character.
+ * @param y  The pen position of the first character.
+ */
+FTGL_EXPORT void ftglRenderTextBlock(FTGLtextblock* block, float x, float y);
+
+FTGL_END_C_DECLS
+
+#endif  //  __FTTextBlock__
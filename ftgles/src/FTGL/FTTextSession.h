@@ -0,0 +1,171 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __ftgl__
+#   warning Please use <FTGL/ftgles.h> instead of <FTTextSession.h>.
+#   include <FTGL/ftgles.h>
+#endif
+
+#ifndef __FTTextSession__
+#define __FTTextSession__
+
+#ifdef __cplusplus
+
+struct ftglesContext;
+
+/**
+ * FTTextSession collects text rendering for a frame into one submission.
+ *
+ * Between Begin() and End(), GL state is saved and set up once, and the
+ * quads of every FTTextureFont and FTBufferFont Render call, from any font,
+ * are collected and drawn together at End(). Text is drawn in the colour
+ * current at Begin(), or the one set with Color().
+ *
+ * The quads are drawn at End(), under the modelview matrix, blend function
+ * and scissor box in effect then. A glTranslatef() or glColor4f() between
+ * two Render calls in a session is lost; place each string with the
+ * position argument of Render and colour it with Color(), which are baked
+ * into its vertices.
+ *
+ * Sessions nest: only the outermost Begin() and End() pair saves state and
+ * draws.
+ *
+ * A session draws into the calling thread's current glue context, or into
+ * the one it was created with, which is made current between Begin() and
+ * End().
+ *
+ * @see FTFont
+ */
+class FTGL_EXPORT FTTextSession
+{
+    public:
+        /**
+         * Default constructor. The session is not started.
+         *
+         * @param context  The glue context to draw into, or NULL for the
+         *                 thread's current one.
+         */
+        FTTextSession(ftglesContext* context = 0);
+
+        /**
+         * Destructor. Ends the session if it is still active.
+         */
+        ~FTTextSession();
+
+        /**
+         * Save GL state and start collecting text. Matrix, colour, blend
+         * and scissor changes made after this call do not apply to the
+         * text collected so far.
+         */
+        void Begin();
+
+        /**
+         * Draw the collected text and restore GL state. All of it is drawn
+         * with the modelview matrix, blend function and scissor box current
+         * at this call.
+         */
+        void End();
+
+        /**
+         * Set the colour of the text rendered after this call.
+         *
+         * @param r  Red component.
+         * @param g  Green component.
+         * @param b  Blue component.
+         * @param a  Alpha component.
+         */
+        void Color(float r, float g, float b, float a);
+
+        /**
+         * Whether Begin() has been called without a matching End().
+         *
+         * @return  <code>true</code> if the session is active.
+         */
+        bool Active() const { return active; }
+
+    private:
+        bool active;
+
+        ftglesContext* context;
+
+        /**
+         * The context that was current before Begin().
+         */
+        ftglesContext* previous;
+};
+
+#endif //__cplusplus
+
+FTGL_BEGIN_C_DECLS
+
+/**
+ * FTGLsession collects text rendering for a frame into one submission.
+ */
+struct _FTGLsession;
+typedef struct _FTGLsession FTGLsession;
+
+/**
+ * Create a text session.
+ *
+ * @return  An FTGLsession* object.
+ */
+FTGL_EXPORT FTGLsession *ftglCreateTextSession(void);
+
+/**
+ * Destroy a text session, ending it if it is active.
+ *
+ * @param session  An FTGLsession* object.
+ */
+FTGL_EXPORT void ftglDestroyTextSession(FTGLsession* session);
+
+/**
+ * Save GL state and start collecting text.
+ *
+ * @param session  An FTGLsession* object.
+ */
+FTGL_EXPORT void ftglBeginTextSession(FTGLsession* session);
+
+/**
+ * Draw the collected text and restore GL state. All of it is drawn with
+ * the modelview matrix, blend function and scissor box current at this call.
+ *
+ * @param session  An FTGLsession* object.
+ */
+FTGL_EXPORT void ftglEndTextSession(FTGLsession* session);
+
+/**
+ * Set the colour of the text rendered after this call.
+ *
+ * @param session  An FTGLsession* object.
+ * @param r  Red component.
+ * @param g  Green component.
+ * @param b  Blue component.
+ * @param a  Alpha component.
+ */
+FTGL_EXPORT void ftglSetTextSessionColor(FTGLsession* session, float r,
+                                         float g, float b, float a);
+
+FTGL_END_C_DECLS
+
+#endif  //  __FTTextSession__
@@ -55,9 +55,11 @@ class FTGL_EXPORT FTTextureGlyph : public FTGlyph
          *                  this glyph
          * @param width     The width of the parent texture
          * @param height    The height (number of rows) of the parent texture
+         * @param upload    <code>false</code> if the texture already holds
+         *                  this glyph's bitmap at the offset (optional)
          */
         FTTextureGlyph(FT_GlyphSlot glyph, int id, int xOffset, int yOffset,
-                       int width, int height);
+                       int width, int height, bool upload = true);
 
         /**
          * Destructor
@@ -67,6 +67,12 @@ namespace FTGL
         ALIGN_RIGHT   = 2,
         ALIGN_JUSTIFY = 3
     } TextAlignment;
+
+    typedef enum
+    {
+        PIXEL_A8    = 0,
+        PIXEL_RGBA8 = 1
+    } PixelFormat;
 }
 #else
 #   define FTGL_RENDER_FRONT 0x0001
@@ -78,6 +84,9 @@ namespace FTGL
 #   define FTGL_ALIGN_CENTER  1
 #   define FTGL_ALIGN_RIGHT   2
 #   define FTGL_ALIGN_JUSTIFY 3
+
+#   define FTGL_PIXEL_A8    0
+#   define FTGL_PIXEL_RGBA8 1
 #endif
 
 // Compiler-specific conditional compilation
@@ -127,15 +136,21 @@ namespace FTGL
 #include "FTTextureGlyph.h"
 
 #include "FTFont.h"
+#include "FTQuadSink.h"
 #include "FTGLBitmapFont.h"
 #include "FTBufferFont.h"
 //#include "FTGLExtrdFont.h"
 #include "FTGLOutlineFont.h"
 #include "FTGLPixmapFont.h"
 #include "FTGLPolygonFont.h"
+#include "FTAtlasManager.h"
 #include "FTGLTextureFont.h"
 
 #include "FTLayout.h"
 #include "FTSimpleLayout.h"
 
+#include "FTTextSession.h"
+#include "FTTextBlock.h"
+#include "FTBitmapRenderer.h"
+
 #endif  //  __ftgl__
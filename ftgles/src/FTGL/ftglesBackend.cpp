@@ -0,0 +1,503 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#include "ftglesGlue.h"
+#include <string.h>
+
+
+//
+//  GLES1 backend: client arrays and fixed function state.
+//
+
+
+static GLvoid ftglesGLES1BeginDraw(void *userData, ftglesClientState_t *state,
+								   const ftglesVertex_t *vertices)
+{
+	glGetPointerv(GL_VERTEX_ARRAY_POINTER, &state->vertexArrayPointer);
+	glGetPointerv(GL_TEXTURE_COORD_ARRAY_POINTER, &state->texCoordArrayPointer);
+	glGetPointerv(GL_COLOR_ARRAY_POINTER, &state->colorArrayPointer);
+
+	glGetBooleanv(GL_VERTEX_ARRAY, &state->vertexArrayEnabled);
+	glGetBooleanv(GL_TEXTURE_COORD_ARRAY, &state->texCoordArrayEnabled);
+	glGetBooleanv(GL_COLOR_ARRAY, &state->colorArrayEnabled);
+
+	state->resetPointers = GL_FALSE;
+	
+	if (!state->vertexArrayEnabled)
+	{
+		glEnableClientState(GL_VERTEX_ARRAY);
+	}
+	
+	if (state->vertexArrayPointer != &vertices[0].xyz)
+	{
+		glGetIntegerv(GL_VERTEX_ARRAY_TYPE, &state->vertexArrayType);
+		glGetIntegerv(GL_VERTEX_ARRAY_SIZE, &state->vertexArraySize);
+		glGetIntegerv(GL_VERTEX_ARRAY_STRIDE, &state->vertexArrayStride);
+		if (state->texCoordArrayEnabled)
+		{
+			glGetIntegerv(GL_TEXTURE_COORD_ARRAY_TYPE, &state->texCoordArrayType);
+			glGetIntegerv(GL_TEXTURE_COORD_ARRAY_SIZE, &state->texCoordArraySize);
+			glGetIntegerv(GL_TEXTURE_COORD_ARRAY_STRIDE, &state->texCoordArrayStride);
+		}	
+		if (state->colorArrayEnabled)
+		{
+			glGetIntegerv(GL_COLOR_ARRAY_TYPE, &state->colorArrayType);
+			glGetIntegerv(GL_COLOR_ARRAY_SIZE, &state->colorArraySize);
+			glGetIntegerv(GL_COLOR_ARRAY_STRIDE, &state->colorArrayStride);
+		}	
+		glVertexPointer(3, GL_FLOAT, sizeof(ftglesVertex_t), vertices[0].xyz);
+		glTexCoordPointer(2, GL_FLOAT, sizeof(ftglesVertex_t), vertices[0].st);
+		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ftglesVertex_t), vertices[0].rgba);
+		
+		state->resetPointers = GL_TRUE;
+	}
+	
+	if (!state->texCoordArrayEnabled)
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+	
+	if (!state->colorArrayEnabled)
+	{
+		glEnableClientState(GL_COLOR_ARRAY);
+	}
+}
+
+
+static GLvoid ftglesGLES1EndDraw(void *userData, const ftglesClientState_t *state)
+{
+	if (state->resetPointers)
+	{
+		if (state->vertexArrayEnabled)
+		{
+			glVertexPointer(state->vertexArraySize, state->vertexArrayType, 
+							state->vertexArrayStride, state->vertexArrayPointer);	
+		}
+		if (state->texCoordArrayEnabled)
+		{
+			glTexCoordPointer(state->texCoordArraySize, state->texCoordArrayType, 
+							  state->texCoordArrayStride, state->texCoordArrayPointer);
+		}
+		if (state->colorArrayEnabled)
+		{
+			glColorPointer(state->colorArraySize, state->colorArrayType, 
+						   state->colorArrayStride, state->colorArrayPointer);
+		}
+	}
+	
+	if (!state->vertexArrayEnabled)
+	{
+		glDisableClientState(GL_VERTEX_ARRAY);
+	}
+	
+	if (!state->texCoordArrayEnabled)
+	{
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+	
+	if (!state->colorArrayEnabled)
+	{
+		glDisableClientState(GL_COLOR_ARRAY);
+	}
+}
+
+
+/*
+ * State replaced while a packed batch is drawn.
+ */
+typedef struct
+{
+	GLint matrixMode;
+	GLfloat color[4];
+} ftglesGLES1PackedState_t;
+
+
+/*
+ * Points the client arrays at a packed batch for one draw. GLES1 has no
+ * normalized texture coordinates, so short ones are scaled back with the
+ * texture matrix. Batches in the full layout use the pointers beginDraw
+ * set, and nothing is changed.
+ */
+static GLvoid ftglesGLES1BeginPacked(const ftglesVertexArray_t *array, ftglesGLES1PackedState_t *state)
+{
+	if (!array->packed)
+	{
+		return;
+	}
+	
+	const GLubyte *p = (const GLubyte *)array->packed;
+	
+	if ((array->format & ~FTGLES_VERTEX_UNIFORM_COLOR) == FTGLES_VERTEX_SHORT)
+	{
+		glVertexPointer(2, GL_SHORT, array->stride, p);
+		p += 2 * sizeof(GLshort);
+	}
+	else
+	{
+		glVertexPointer(2, GL_FLOAT, array->stride, p);
+		p += 2 * sizeof(GLfloat);
+	}
+	
+	glTexCoordPointer(2, GL_SHORT, array->stride, p);
+	p += 2 * sizeof(GLshort);
+	
+	if (array->format & FTGLES_VERTEX_UNIFORM_COLOR)
+	{
+		const GLubyte *rgba = array->vertices[0].rgba;
+		
+		glGetFloatv(GL_CURRENT_COLOR, state->color);
+		glDisableClientState(GL_COLOR_ARRAY);
+		glColor4ub(rgba[0], rgba[1], rgba[2], rgba[3]);
+	}
+	else
+	{
+		glColorPointer(4, GL_UNSIGNED_BYTE, array->stride, p);
+	}
+	
+	glGetIntegerv(GL_MATRIX_MODE, &state->matrixMode);
+	glMatrixMode(GL_TEXTURE);
+	glPushMatrix();
+	glScalef(1.0f / FTGLES_TEXCOORD_SCALE, 1.0f / FTGLES_TEXCOORD_SCALE, 1.0f);
+}
+
+
+static GLvoid ftglesGLES1EndPacked(const ftglesVertexArray_t *array, const ftglesGLES1PackedState_t *state)
+{
+	if (!array->packed)
+	{
+		return;
+	}
+	
+	const ftglesVertex_t *vertices = array->vertices;
+	
+	glPopMatrix();
+	glMatrixMode(state->matrixMode);
+	
+	if (array->format & FTGLES_VERTEX_UNIFORM_COLOR)
+	{
+		glColor4f(state->color[0], state->color[1], state->color[2], state->color[3]);
+		glEnableClientState(GL_COLOR_ARRAY);
+	}
+	
+	glVertexPointer(3, GL_FLOAT, sizeof(ftglesVertex_t), vertices[0].xyz);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(ftglesVertex_t), vertices[0].st);
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ftglesVertex_t), vertices[0].rgba);
+}
+
+
+static GLvoid ftglesGLES1DrawElements(void *userData, const ftglesVertexArray_t *array,
+									  const GLushort *indices, GLsizei count, GLuint texture)
+{
+	ftglesGLES1PackedState_t state;
+	
+	/* Texture 0 leaves the unit incomplete, so the batch is untextured. */
+	glBindTexture(GL_TEXTURE_2D, texture);
+	
+	ftglesGLES1BeginPacked(array, &state);
+	glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, indices);
+	ftglesGLES1EndPacked(array, &state);
+}
+
+
+static GLvoid ftglesGLES1DrawArrays(void *userData, GLenum prim, const ftglesVertexArray_t *array,
+									GLsizei count, GLuint texture)
+{
+	ftglesGLES1PackedState_t state;
+	
+	/* Texture 0 leaves the unit incomplete, so the batch is untextured. */
+	glBindTexture(GL_TEXTURE_2D, texture);
+	
+	ftglesGLES1BeginPacked(array, &state);
+	glDrawArrays(prim, 0, count);
+	ftglesGLES1EndPacked(array, &state);
+}
+
+
+static GLvoid ftglesGLES1SaveTextState(void *userData, ftglesTextState_t *state)
+{
+	state->blendEnabled = glIsEnabled(GL_BLEND);
+	state->texture2DEnabled = glIsEnabled(GL_TEXTURE_2D);
+	
+	if (!state->blendEnabled)
+	{
+		glEnable(GL_BLEND);
+	}
+	else 
+	{
+		glGetIntegerv(GL_BLEND_SRC, &state->blendSrc);
+		glGetIntegerv(GL_BLEND_DST, &state->blendDst);
+	}
+	
+	if (!state->texture2DEnabled)
+	{
+		glEnable(GL_TEXTURE_2D);
+	}
+	
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	
+	state->alphaTestEnabled = glIsEnabled(GL_ALPHA_TEST);
+	if (state->alphaTestEnabled)
+	{
+		glGetIntegerv(GL_ALPHA_TEST_FUNC, &state->alphaFunc);
+		glGetFloatv(GL_ALPHA_TEST_REF, &state->alphaRef);
+	}
+}
+
+
+static GLvoid ftglesGLES1RestoreTextState(void *userData, const ftglesTextState_t *state)
+{
+	if (!state->blendEnabled)
+	{
+		glDisable(GL_BLEND);
+	}
+	else
+	{
+		glBlendFunc(state->blendSrc, state->blendDst);
+	}
+	
+	if (!state->texture2DEnabled)
+	{
+		glDisable(GL_TEXTURE_2D);
+	}
+	
+	if (state->alphaTestEnabled)
+	{
+		glEnable(GL_ALPHA_TEST);
+		glAlphaFunc(state->alphaFunc, state->alphaRef);
+	}
+	else
+	{
+		glDisable(GL_ALPHA_TEST);
+	}
+}
+
+
+static GLvoid ftglesGLES1CurrentColor(void *userData, GLfloat rgba[4])
+{
+	glGetFloatv(GL_CURRENT_COLOR, rgba);
+}
+
+
+static GLuint ftglesGLES1CreateTexture(void *userData)
+{
+	GLuint texture;
+	
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	
+	return texture;
+}
+
+
+static GLvoid ftglesGLES1TextureImage(void *userData, GLuint texture, GLsizei width,
+									  GLsizei height, const GLvoid *pixels)
+{
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, width, height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, pixels);
+}
+
+
+static GLvoid ftglesGLES1TextureSubImage(void *userData, GLuint texture, GLint x, GLint y,
+										 GLsizei width, GLsizei height, const GLvoid *pixels)
+{
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_ALPHA, GL_UNSIGNED_BYTE, pixels);
+}
+
+
+static GLvoid ftglesGLES1DeleteTextures(void *userData, GLsizei n, const GLuint *textures)
+{
+	glDeleteTextures(n, textures);
+}
+
+
+static GLint ftglesGLES1MaxTextureSize(void *userData)
+{
+	GLint size = 0;
+	
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &size);
+	return size;
+}
+
+
+static GLvoid ftglesGLES1AlphaTest(void *userData, GLfloat threshold)
+{
+	if (threshold > 0.0f)
+	{
+		glEnable(GL_ALPHA_TEST);
+		glAlphaFunc(GL_GEQUAL, threshold);
+	}
+	else
+	{
+		glDisable(GL_ALPHA_TEST);
+	}
+}
+
+
+const ftglesBackend_t ftglesGLES1Backend =
+{
+	NULL,
+	ftglesGLES1BeginDraw,
+	ftglesGLES1EndDraw,
+	ftglesGLES1DrawElements,
+	ftglesGLES1DrawArrays,
+	ftglesGLES1SaveTextState,
+	ftglesGLES1RestoreTextState,
+	ftglesGLES1CurrentColor,
+	ftglesGLES1CreateTexture,
+	ftglesGLES1TextureImage,
+	ftglesGLES1TextureSubImage,
+	ftglesGLES1DeleteTextures,
+	ftglesGLES1MaxTextureSize,
+	ftglesGLES1AlphaTest
+};
+
+
+//
+//  Recording backend: counts what would be drawn, without touching GL.
+//
+
+
+static GLvoid ftglesRecordBeginDraw(void *userData, ftglesClientState_t *state,
+									const ftglesVertex_t *vertices)
+{
+	((ftglesRecording_t *)userData)->stateSaves++;
+}
+
+
+static GLvoid ftglesRecordEndDraw(void *userData, const ftglesClientState_t *state)
+{
+}
+
+
+static GLvoid ftglesRecordDrawElements(void *userData, const ftglesVertexArray_t *array,
+									   const GLushort *indices, GLsizei count, GLuint texture)
+{
+	ftglesRecording_t *recording = (ftglesRecording_t *)userData;
+	
+	recording->draws++;
+	recording->texture = texture;
+	recording->indices += count;
+	recording->vertices += count / 6 * 4;
+	recording->vertexBytes += count / 6 * 4 * array->stride;
+}
+
+
+static GLvoid ftglesRecordDrawArrays(void *userData, GLenum prim, const ftglesVertexArray_t *array,
+									 GLsizei count, GLuint texture)
+{
+	ftglesRecording_t *recording = (ftglesRecording_t *)userData;
+	
+	recording->draws++;
+	recording->texture = texture;
+	recording->vertices += count;
+	recording->vertexBytes += count * array->stride;
+}
+
+
+static GLvoid ftglesRecordSaveTextState(void *userData, ftglesTextState_t *state)
+{
+	((ftglesRecording_t *)userData)->stateSaves++;
+}
+
+
+static GLvoid ftglesRecordRestoreTextState(void *userData, const ftglesTextState_t *state)
+{
+}
+
+
+static GLvoid ftglesRecordCurrentColor(void *userData, GLfloat rgba[4])
+{
+	rgba[0] = rgba[1] = rgba[2] = rgba[3] = 1.0f;
+}
+
+
+static GLuint ftglesRecordCreateTexture(void *userData)
+{
+	return ++((ftglesRecording_t *)userData)->textures;
+}
+
+
+static GLvoid ftglesRecordTextureImage(void *userData, GLuint texture, GLsizei width,
+									   GLsizei height, const GLvoid *pixels)
+{
+	ftglesRecording_t *recording = (ftglesRecording_t *)userData;
+	
+	recording->uploads++;
+	recording->uploadBytes += width * height;
+}
+
+
+static GLvoid ftglesRecordTextureSubImage(void *userData, GLuint texture, GLint x, GLint y,
+										  GLsizei width, GLsizei height, const GLvoid *pixels)
+{
+	ftglesRecording_t *recording = (ftglesRecording_t *)userData;
+	
+	recording->uploads++;
+	recording->uploadBytes += width * height;
+}
+
+
+static GLvoid ftglesRecordDeleteTextures(void *userData, GLsizei n, const GLuint *textures)
+{
+}
+
+
+static GLint ftglesRecordMaxTextureSize(void *userData)
+{
+	return 2048;
+}
+
+
+static GLvoid ftglesRecordAlphaTest(void *userData, GLfloat threshold)
+{
+	((ftglesRecording_t *)userData)->alphaTest = threshold;
+}
+
+
+GLvoid ftglesInitRecordingBackend(ftglesBackend_t *backend, ftglesRecording_t *recording)
+{
+	memset(recording, 0, sizeof(ftglesRecording_t));
+	
+	backend->userData = recording;
+	backend->beginDraw = ftglesRecordBeginDraw;
+	backend->endDraw = ftglesRecordEndDraw;
+	backend->drawElements = ftglesRecordDrawElements;
+	backend->drawArrays = ftglesRecordDrawArrays;
+	backend->saveTextState = ftglesRecordSaveTextState;
+	backend->restoreTextState = ftglesRecordRestoreTextState;
+	backend->currentColor = ftglesRecordCurrentColor;
+	backend->createTexture = ftglesRecordCreateTexture;
+	backend->textureImage = ftglesRecordTextureImage;
+	backend->textureSubImage = ftglesRecordTextureSubImage;
+	backend->deleteTextures = ftglesRecordDeleteTextures;
+	backend->maxTextureSize = ftglesRecordMaxTextureSize;
+	backend->alphaTest = ftglesRecordAlphaTest;
+}
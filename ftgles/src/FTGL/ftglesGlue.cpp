@@ -23,103 +23,409 @@
  */
 
 #include "ftglesGlue.h"
-#define FTGLES_GLUE_MAX_VERTICES 32768
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
-typedef struct 
+#include <pthread.h>
+
+/* Quad indices are GLushort, so a batch can address at most this many. */
+#define FTGLES_GLUE_MAX_VERTICES 65536
+#define FTGLES_GLUE_MIN_VERTICES 64
+
+
+/*
+ * Everything a session defers until ftglesEndSession.
+ */
+typedef struct
 {
-	float xyz[3];
-	float st[2];
-	GLubyte rgba[4];
-} ftglesVertex_t;
+	int depth;
+	ftglesClientState_t clientState;
+	ftglesTextState_t textState;
+} ftglesSession_t;
 
 
-typedef struct 
+struct ftglesContext
 {
-	ftglesVertex_t vertices[FTGLES_GLUE_MAX_VERTICES];
-	short quadIndices[FTGLES_GLUE_MAX_VERTICES * 3 / 2];
+	unsigned int capacity;
+	ftglesVertex_t *vertices;
+	GLushort *quadIndices;
 	ftglesVertex_t currVertex;
 	unsigned int currIndex;
-} ftglesGlueArrays_t;
+	GLenum primitive;
+	
+	/*
+	 * The texture each quad was emitted with. Quads are sorted by texture
+	 * into sortedIndices so each texture is drawn with a single call.
+	 */
+	GLuint *quadTextures;
+	GLushort *sortedIndices;
+	GLuint currTexture;
+	bool textured;
+	
+	/* 
+	 * A GL_LINE_LOOP that had to be flushed part way through is carried on
+	 * as a line strip, and closed with this vertex at ftglEnd.
+	 */
+	ftglesVertex_t loopStart;
+	bool loopSplit;
+	
+	ftglesSession_t session;
+	
+	const ftglesBackend_t *backend;
+	
+	/*
+	 * The layout batches are handed to the backend in, and the array they
+	 * are packed into when it is not FTGLES_VERTEX_FLOAT.
+	 */
+	unsigned int format;
+	GLubyte *packed;
+	
+	/*
+	 * When set, GL_QUADS batches are recorded here instead of being drawn.
+	 */
+	ftglesCapture_t *capture;
+};
+
+
+/*
+ * Each thread has a current context, and a default one that is created the
+ * first time the thread draws without choosing a context and destroyed
+ * when the thread exits.
+ */
+static pthread_key_t ftglesCurrentKey;
+static pthread_key_t ftglesDefaultKey;
+/* The calling thread's context from ftglBegin until ftglEnd. */
+static pthread_key_t ftglesBatchKey;
+static pthread_once_t ftglesKeysOnce = PTHREAD_ONCE_INIT;
+
+
+static void ftglesDestroyDefaultContext(void *context)
+{
+	ftglesDestroyContext((ftglesContext *)context);
+}
+
+
+static void ftglesCreateKeys()
+{
+	pthread_key_create(&ftglesCurrentKey, NULL);
+	pthread_key_create(&ftglesDefaultKey, ftglesDestroyDefaultContext);
+	pthread_key_create(&ftglesBatchKey, NULL);
+}
+
+
+static ftglesContext *ftglesCurrent()
+{
+	pthread_once(&ftglesKeysOnce, ftglesCreateKeys);
+	
+	ftglesContext *c = (ftglesContext *)pthread_getspecific(ftglesCurrentKey);
+	if (c)
+	{
+		return c;
+	}
+	
+	c = (ftglesContext *)pthread_getspecific(ftglesDefaultKey);
+	if (!c)
+	{
+		c = ftglesCreateContext(0);
+		assert(c);
+		pthread_setspecific(ftglesDefaultKey, c);
+	}
+	
+	pthread_setspecific(ftglesCurrentKey, c);
+	return c;
+}
+
+
+/*
+ * The current context for calls made per vertex: a single key lookup when
+ * a batch is open, without falling back to the default context.
+ */
+static inline ftglesContext *ftglesBatchCurrent()
+{
+	pthread_once(&ftglesKeysOnce, ftglesCreateKeys);
+	
+	ftglesContext *c = (ftglesContext *)pthread_getspecific(ftglesBatchKey);
+	return c ? c : ftglesCurrent();
+}
+
+
+/*
+ * Whether GL_QUADS batches are held back until the end of a session or
+ * capture rather than drawn at ftglEnd.
+ */
+static inline bool ftglesDeferQuads(ftglesContext *c)
+{
+	return c->session.depth || c->capture;
+}
+
+
+ftglesContext *ftglesCreateContext(unsigned int maxVertices)
+{
+	if (maxVertices == 0)
+	{
+		maxVertices = FTGLES_GLUE_DEFAULT_VERTICES;
+	}
+	else if (maxVertices < FTGLES_GLUE_MIN_VERTICES)
+	{
+		maxVertices = FTGLES_GLUE_MIN_VERTICES;
+	}
+	else if (maxVertices > FTGLES_GLUE_MAX_VERTICES)
+	{
+		maxVertices = FTGLES_GLUE_MAX_VERTICES;
+	}
+	maxVertices -= maxVertices % 4;
+	
+	ftglesContext *c = (ftglesContext *)calloc(1, sizeof(ftglesContext));
+	if (!c)
+	{
+		return NULL;
+	}
+	
+	c->capacity = maxVertices;
+	c->vertices = (ftglesVertex_t *)malloc(maxVertices * sizeof(ftglesVertex_t));
+	c->quadIndices = (GLushort *)malloc(maxVertices * 3 / 2 * sizeof(GLushort));
+	c->quadTextures = (GLuint *)malloc(maxVertices / 4 * sizeof(GLuint));
+	c->sortedIndices = (GLushort *)malloc(maxVertices * 3 / 2 * sizeof(GLushort));
+	
+	if (!c->vertices || !c->quadIndices || !c->quadTextures || !c->sortedIndices)
+	{
+		ftglesDestroyContext(c);
+		return NULL;
+	}
+	
+	for (unsigned int i = 0; i < maxVertices * 3 / 2; i += 6) 
+	{
+		GLushort q = i / 6 * 4;
+		c->quadIndices[i + 0] = q + 0;
+		c->quadIndices[i + 1] = q + 1;
+		c->quadIndices[i + 2] = q + 2;
+		
+		c->quadIndices[i + 3] = q + 0;
+		c->quadIndices[i + 4] = q + 2;
+		c->quadIndices[i + 5] = q + 3;
+	}
+	
+	c->currVertex.rgba[0] = c->currVertex.rgba[1] = 255;
+	c->currVertex.rgba[2] = c->currVertex.rgba[3] = 255;
+	c->primitive = GL_TRIANGLES;
+	c->backend = &ftglesGLES1Backend;
+	
+	return c;
+}
+
+
+GLvoid ftglesDestroyContext(ftglesContext *context)
+{
+	if (!context)
+	{
+		return;
+	}
+	
+	pthread_once(&ftglesKeysOnce, ftglesCreateKeys);
+	
+	if (pthread_getspecific(ftglesBatchKey) == context)
+	{
+		pthread_setspecific(ftglesBatchKey, NULL);
+	}
+	
+	if (pthread_getspecific(ftglesCurrentKey) == context)
+	{
+		pthread_setspecific(ftglesCurrentKey, NULL);
+	}
+	
+	if (pthread_getspecific(ftglesDefaultKey) == context)
+	{
+		pthread_setspecific(ftglesDefaultKey, NULL);
+	}
+	
+	free(context->vertices);
+	free(context->quadIndices);
+	free(context->quadTextures);
+	free(context->sortedIndices);
+	free(context->packed);
+	free(context);
+}
+
+
+GLvoid ftglesMakeCurrent(ftglesContext *context)
+{
+	pthread_once(&ftglesKeysOnce, ftglesCreateKeys);
+	pthread_setspecific(ftglesCurrentKey, context);
+	pthread_setspecific(ftglesBatchKey, NULL);
+}
+
+
+ftglesContext *ftglesGetCurrentContext()
+{
+	return ftglesCurrent();
+}
+
+
+static GLvoid ftglesFlushVertices(ftglesContext *c);
+static GLvoid ftglesDrawVertices(ftglesContext *c, GLenum prim, unsigned int count);
+
 
-ftglesGlueArrays_t ftglesGlueArrays;
+/*
+ * Makes room in a capture for <code>count</code> more vertices.
+ */
+static bool ftglesReserveCapture(ftglesCapture_t *capture, unsigned int count)
+{
+	unsigned int needed = capture->count + count;
+	
+	if (needed <= capture->capacity)
+	{
+		return true;
+	}
+	
+	unsigned int capacity = capture->capacity ? capture->capacity : 64;
+	while (capacity < needed)
+	{
+		capacity *= 2;
+	}
+	
+	ftglesVertex_t *vertices = (ftglesVertex_t *)realloc(capture->vertices, capacity * sizeof(ftglesVertex_t));
+	if (!vertices)
+	{
+		return false;
+	}
+	capture->vertices = vertices;
+	
+	GLuint *textures = (GLuint *)realloc(capture->textures, capacity / 4 * sizeof(GLuint));
+	if (!textures)
+	{
+		return false;
+	}
+	capture->textures = textures;
+	capture->capacity = capacity;
+	
+	return true;
+}
+
+
+/*
+ * Appends the first <code>count</code> quad vertices of the array to a
+ * capture, with the texture of each quad.
+ */
+static GLvoid ftglesCaptureVertices(ftglesContext *c, ftglesCapture_t *capture, unsigned int count)
+{
+	count -= count % 4;
+	
+	if (capture->emit)
+	{
+		capture->emit(capture->userData, c->vertices, c->quadTextures, count);
+		capture->count += count;
+		return;
+	}
+	
+	if (!ftglesReserveCapture(capture, count))
+	{
+		return;
+	}
+	
+	memcpy(capture->vertices + capture->count, c->vertices, count * sizeof(ftglesVertex_t));
+	memcpy(capture->textures + capture->count / 4, c->quadTextures, count / 4 * sizeof(GLuint));
+	capture->count += count;
+}
 
-GLenum ftglesCurrentPrimitive = GL_TRIANGLES;
-bool ftglesQuadIndicesInitted = false;
 
 GLvoid ftglBegin(GLenum prim) 
 {
-	if (!ftglesQuadIndicesInitted)
+	ftglesContext *c = ftglesCurrent();
+	
+	pthread_setspecific(ftglesBatchKey, c);
+	
+	if (ftglesDeferQuads(c))
 	{
-		for (int i = 0; i < FTGLES_GLUE_MAX_VERTICES * 3 / 2; i += 6) 
+		/* Quads keep collecting until the session ends. */
+		if (prim == GL_QUADS && c->primitive == GL_QUADS)
 		{
-			int q = i / 6 * 4;
-			ftglesGlueArrays.quadIndices[i + 0] = q + 0;
-			ftglesGlueArrays.quadIndices[i + 1] = q + 1;
-			ftglesGlueArrays.quadIndices[i + 2] = q + 2;
-			
-			ftglesGlueArrays.quadIndices[i + 3] = q + 0;
-			ftglesGlueArrays.quadIndices[i + 4] = q + 2;
-			ftglesGlueArrays.quadIndices[i + 5] = q + 3;
+			return;
 		}
-		ftglesQuadIndicesInitted = true;
+		
+		/* Anything else is drawn in order, after the quads collected so far. */
+		ftglesDrawVertices(c, c->primitive, c->currIndex);
 	}
-	ftglesGlueArrays.currIndex = 0;
-	ftglesCurrentPrimitive = prim;
+	
+	c->currIndex = 0;
+	c->loopSplit = false;
+	c->textured = false;
+	c->primitive = prim;
 }
 
 
 GLvoid ftglVertex3f(float x, float y, float z) 
 {
-	if (ftglesGlueArrays.currIndex >= FTGLES_GLUE_MAX_VERTICES)
+	ftglesContext *c = ftglesBatchCurrent();
+	
+	if (c->currIndex >= c->capacity)
 	{
-		return;
+		ftglesFlushVertices(c);
 	}
 	
-	ftglesGlueArrays.currVertex.xyz[0] = x;
-	ftglesGlueArrays.currVertex.xyz[1] = y;
-	ftglesGlueArrays.currVertex.xyz[2] = z;
-	ftglesGlueArrays.vertices[ftglesGlueArrays.currIndex] = ftglesGlueArrays.currVertex;
-	ftglesGlueArrays.currIndex++;
+	if ((c->currIndex & 3) == 0)
+	{
+		c->quadTextures[c->currIndex >> 2] = c->currTexture;
+	}
+	
+	c->currVertex.xyz[0] = x;
+	c->currVertex.xyz[1] = y;
+	c->currVertex.xyz[2] = z;
+	c->vertices[c->currIndex] = c->currVertex;
+	c->currIndex++;
 }
 
 
 GLvoid ftglVertex2f(float x, float y) 
 {
-	if (ftglesGlueArrays.currIndex >= FTGLES_GLUE_MAX_VERTICES)
+	ftglesContext *c = ftglesBatchCurrent();
+	
+	if (c->currIndex >= c->capacity)
 	{
-		return;
+		ftglesFlushVertices(c);
+	}
+	
+	if ((c->currIndex & 3) == 0)
+	{
+		c->quadTextures[c->currIndex >> 2] = c->currTexture;
 	}
 	
-	ftglesGlueArrays.currVertex.xyz[0] = x;
-	ftglesGlueArrays.currVertex.xyz[1] = y;
-	ftglesGlueArrays.currVertex.xyz[2] = 0.0f;
-	ftglesGlueArrays.vertices[ftglesGlueArrays.currIndex] = ftglesGlueArrays.currVertex;
-	ftglesGlueArrays.currIndex++;
+	c->currVertex.xyz[0] = x;
+	c->currVertex.xyz[1] = y;
+	c->currVertex.xyz[2] = 0.0f;
+	c->vertices[c->currIndex] = c->currVertex;
+	c->currIndex++;
 }
 
 
 GLvoid ftglColor4ub(GLubyte r, GLubyte g, GLubyte b, GLubyte a) 
 {
-	ftglesGlueArrays.currVertex.rgba[0] = r;
-	ftglesGlueArrays.currVertex.rgba[1] = g;
-	ftglesGlueArrays.currVertex.rgba[2] = b;
-	ftglesGlueArrays.currVertex.rgba[3] = a;
+	ftglesContext *c = ftglesBatchCurrent();
+	
+	c->currVertex.rgba[0] = r;
+	c->currVertex.rgba[1] = g;
+	c->currVertex.rgba[2] = b;
+	c->currVertex.rgba[3] = a;
 }
 
 
 GLvoid ftglColor4f(GLfloat r, GLfloat g, GLfloat b, GLfloat a) 
 {
-	ftglesGlueArrays.currVertex.rgba[0] = (GLubyte) (r * 255);
-	ftglesGlueArrays.currVertex.rgba[1] = (GLubyte) (g * 255);
-	ftglesGlueArrays.currVertex.rgba[2] = (GLubyte) (b * 255);
-	ftglesGlueArrays.currVertex.rgba[3] = (GLubyte) (a * 255);
+	ftglesContext *c = ftglesBatchCurrent();
+	
+	c->currVertex.rgba[0] = (GLubyte) (r * 255);
+	c->currVertex.rgba[1] = (GLubyte) (g * 255);
+	c->currVertex.rgba[2] = (GLubyte) (b * 255);
+	c->currVertex.rgba[3] = (GLubyte) (a * 255);
 }
 
 
 GLvoid ftglTexCoord2f(GLfloat s, GLfloat t) 
 {
-	ftglesGlueArrays.currVertex.st[0] = s;
-	ftglesGlueArrays.currVertex.st[1] = t;
+	ftglesContext *c = ftglesBatchCurrent();
+	
+	c->currVertex.st[0] = s;
+	c->currVertex.st[1] = t;
 }
 
 
@@ -128,128 +434,618 @@ GLvoid bindArrayBuffers()
 }
 
 
-GLvoid ftglBindTexture()
+GLvoid ftglBindTexture(GLuint texture)
 {
+	ftglesContext *c = ftglesBatchCurrent();
 	
+	c->currTexture = texture;
+	c->textured = true;
 }
 
 
-GLvoid ftglEnd() 
+#define FTGLES_QUAD_DRAWN ((GLuint)~0)
+
+/*
+ * Describes the first <code>count</code> vertices of the batch to the
+ * backend, packing them into the context's vertex format if it is not the
+ * full one.
+ */
+static GLvoid ftglesPackVertices(ftglesContext *c, unsigned int count, ftglesVertexArray_t *array)
 {
-	GLboolean vertexArrayEnabled;
-	GLboolean texCoordArrayEnabled;
-	GLboolean colorArrayEnabled;
+	unsigned int format = c->format;
 	
-	GLvoid * vertexArrayPointer;
-	GLvoid * texCoordArrayPointer;
-	GLvoid * colorArrayPointer;
+	array->vertices = c->vertices;
+	array->packed = NULL;
+	array->format = format;
+	array->stride = ftglesVertexStride(format);
 	
-	GLint vertexArrayType, texCoordArrayType, colorArrayType;
-	GLint vertexArraySize, texCoordArraySize, colorArraySize;
-	GLsizei vertexArrayStride, texCoordArrayStride, colorArrayStride;
+	if (format == FTGLES_VERTEX_FLOAT)
+	{
+		return;
+	}
 	
-	bool resetPointers = false;
+	if (!c->packed)
+	{
+		/* Large enough for the widest compact format. */
+		c->packed = (GLubyte *)malloc(c->capacity * 16);
+		if (!c->packed)
+		{
+			array->format = FTGLES_VERTEX_FLOAT;
+			array->stride = sizeof(ftglesVertex_t);
+			return;
+		}
+	}
 	
-	glGetPointerv(GL_VERTEX_ARRAY_POINTER, &vertexArrayPointer);
-	glGetPointerv(GL_TEXTURE_COORD_ARRAY_POINTER, &texCoordArrayPointer);
-	glGetPointerv(GL_COLOR_ARRAY_POINTER, &colorArrayPointer);
+	const ftglesVertex_t *v = c->vertices;
+	GLubyte *out = c->packed;
+	bool shortPositions = (format & ~FTGLES_VERTEX_UNIFORM_COLOR) == FTGLES_VERTEX_SHORT;
+	bool colors = !(format & FTGLES_VERTEX_UNIFORM_COLOR);
+	
+	for (unsigned int i = 0; i < count; ++i, ++v)
+	{
+		GLubyte *p = out;
+		
+		if (shortPositions)
+		{
+			GLshort *xy = (GLshort *)p;
+			xy[0] = (GLshort)floorf(v->xyz[0] + 0.5f);
+			xy[1] = (GLshort)floorf(v->xyz[1] + 0.5f);
+			p += 2 * sizeof(GLshort);
+		}
+		else
+		{
+			GLfloat *xy = (GLfloat *)p;
+			xy[0] = v->xyz[0];
+			xy[1] = v->xyz[1];
+			p += 2 * sizeof(GLfloat);
+		}
+		
+		GLshort *st = (GLshort *)p;
+		st[0] = (GLshort)(v->st[0] * FTGLES_TEXCOORD_SCALE + 0.5f);
+		st[1] = (GLshort)(v->st[1] * FTGLES_TEXCOORD_SCALE + 0.5f);
+		p += 2 * sizeof(GLshort);
+		
+		if (colors)
+		{
+			memcpy(p, v->rgba, 4);
+		}
+		
+		out += array->stride;
+	}
+	
+	array->packed = c->packed;
+}
 
-	glGetBooleanv(GL_VERTEX_ARRAY, &vertexArrayEnabled);
-	glGetBooleanv(GL_TEXTURE_COORD_ARRAY, &texCoordArrayEnabled);
-	glGetBooleanv(GL_COLOR_ARRAY, &colorArrayEnabled);
 
-	if (!vertexArrayEnabled)
+/*
+ * Draws a quad batch with one call per texture. Quads keep their relative
+ * order within a texture. The quad texture tags are consumed.
+ */
+static GLvoid ftglesDrawTexturedQuads(ftglesContext *c, const ftglesVertexArray_t *array,
+									  unsigned int count)
+{
+	const ftglesBackend_t *backend = c->backend;
+	GLuint *tags = c->quadTextures;
+	GLushort *indices = c->sortedIndices;
+	unsigned int quads = count / 4;
+	unsigned int first = 0;
+	
+	/* Single texture batch: the precomputed indices are already in order. */
+	while (first < quads && tags[first] == tags[0])
 	{
-		glEnableClientState(GL_VERTEX_ARRAY);
+		++first;
 	}
 	
-	if (vertexArrayPointer != &ftglesGlueArrays.vertices[0].xyz)
+	if (first == quads)
 	{
-		glGetIntegerv(GL_VERTEX_ARRAY_TYPE, &vertexArrayType);
-		glGetIntegerv(GL_VERTEX_ARRAY_SIZE, &vertexArraySize);
-		glGetIntegerv(GL_VERTEX_ARRAY_STRIDE, &vertexArrayStride);
-		if (texCoordArrayEnabled)
-		{
-			glGetIntegerv(GL_TEXTURE_COORD_ARRAY_TYPE, &texCoordArrayType);
-			glGetIntegerv(GL_TEXTURE_COORD_ARRAY_SIZE, &texCoordArraySize);
-			glGetIntegerv(GL_TEXTURE_COORD_ARRAY_STRIDE, &texCoordArrayStride);
-		}	
-		if (colorArrayEnabled)
+		backend->drawElements(backend->userData, array, c->quadIndices, quads * 6, tags[0]);
+		return;
+	}
+	
+	first = 0;
+	while (first < quads)
+	{
+		GLuint texture = tags[first];
+		unsigned int next = quads;
+		unsigned int n = 0;
+		
+		for (unsigned int q = first; q < quads; ++q)
 		{
-			glGetIntegerv(GL_COLOR_ARRAY_TYPE, &colorArrayType);
-			glGetIntegerv(GL_COLOR_ARRAY_SIZE, &colorArraySize);
-			glGetIntegerv(GL_COLOR_ARRAY_STRIDE, &colorArrayStride);
-		}	
-		glVertexPointer(3, GL_FLOAT, sizeof(ftglesVertex_t), ftglesGlueArrays.vertices[0].xyz);
-		glTexCoordPointer(2, GL_FLOAT, sizeof(ftglesVertex_t), ftglesGlueArrays.vertices[0].st);
-		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ftglesVertex_t), ftglesGlueArrays.vertices[0].rgba);
+			if (tags[q] == texture)
+			{
+				GLushort v = q * 4;
+				indices[n + 0] = v + 0;
+				indices[n + 1] = v + 1;
+				indices[n + 2] = v + 2;
+				indices[n + 3] = v + 0;
+				indices[n + 4] = v + 2;
+				indices[n + 5] = v + 3;
+				n += 6;
+				tags[q] = FTGLES_QUAD_DRAWN;
+			}
+			else if (next == quads && tags[q] != FTGLES_QUAD_DRAWN)
+			{
+				next = q;
+			}
+		}
 		
-		resetPointers = true;
+		backend->drawElements(backend->userData, array, indices, n, texture);
+		first = next;
 	}
+}
+
+
+/*
+ * Draws the first <code>count</code> vertices of the array with the given
+ * primitive. Outside a session, client state is saved before and restored
+ * after the draw; a session does that once for all of its draws.
+ */
+static GLvoid ftglesDrawVertices(ftglesContext *c, GLenum prim, unsigned int count)
+{
+	const ftglesBackend_t *backend = c->backend;
+	ftglesClientState_t clientState;
+	ftglesVertexArray_t array;
 	
-	if (!texCoordArrayEnabled)
+	if (count == 0)
 	{
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		return;
 	}
 	
-	if (!colorArrayEnabled)
+	if (prim == GL_QUADS && c->capture)
 	{
-		glEnableClientState(GL_COLOR_ARRAY);
+		ftglesCaptureVertices(c, c->capture, count);
+		return;
 	}
 	
-	if (ftglesGlueArrays.currIndex == 0) 
+	if (!c->session.depth)
 	{
-		ftglesCurrentPrimitive = 0;
-		return;
+		backend->beginDraw(backend->userData, &clientState, c->vertices);
 	}
 	
-	if (ftglesCurrentPrimitive == GL_QUADS) 
+	ftglesPackVertices(c, count, &array);
+	
+	if (prim == GL_QUADS && c->textured)
 	{
-		glDrawElements(GL_TRIANGLES, ftglesGlueArrays.currIndex / 4 * 6, GL_UNSIGNED_SHORT, ftglesGlueArrays.quadIndices);
+		ftglesDrawTexturedQuads(c, &array, count);
+	}
+	else if (prim == GL_QUADS) 
+	{
+		backend->drawElements(backend->userData, &array, c->quadIndices, count / 4 * 6, 0);
 	} 
 	else 
 	{
-		glDrawArrays(ftglesCurrentPrimitive, 0, ftglesGlueArrays.currIndex);
+		backend->drawArrays(backend->userData, prim, &array, count, c->textured ? c->currTexture : 0);
+	}
+	
+	if (!c->session.depth)
+	{
+		backend->endDraw(backend->userData, &clientState);
 	}
-	ftglesGlueArrays.currIndex = 0;
-	ftglesCurrentPrimitive = 0;
+}
+
+
+/*
+ * Called when the vertex array is full part way through a primitive.
+ * Draws every complete primitive in the array, then moves the vertices
+ * needed to carry on the current primitive to the front of the array.
+ * Quads, triangles and lines are split on whole primitive boundaries, so
+ * the precomputed quad indices always line up with the array.
+ */
+static GLvoid ftglesFlushVertices(ftglesContext *c)
+{
+	ftglesVertex_t *vertices = c->vertices;
+	unsigned int count = c->currIndex;
+	unsigned int drawn = count;
+	ftglesVertex_t carry[3];
+	unsigned int carried = 0;
+	GLenum prim = c->primitive;
 	
-	if (resetPointers)
+	switch (prim)
 	{
-		if (vertexArrayEnabled)
+		case GL_QUADS:
+			drawn = count - count % 4;
+			break;
+		case GL_TRIANGLES:
+			drawn = count - count % 3;
+			break;
+		case GL_LINES:
+			drawn = count - count % 2;
+			break;
+		case GL_LINE_LOOP:
+			/* Draw the first part as a strip, and close the loop at the end. */
+			c->loopStart = vertices[0];
+			c->loopSplit = true;
+			c->primitive = prim = GL_LINE_STRIP;
+			carry[carried++] = vertices[count - 1];
+			break;
+		case GL_LINE_STRIP:
+			carry[carried++] = vertices[count - 1];
+			break;
+		case GL_TRIANGLE_STRIP:
+			/* 
+			 * Strip winding alternates. If the next triangle has odd parity
+			 * in the original strip, start with a degenerate triangle so it
+			 * keeps its winding in the new one.
+			 */
+			if (count % 2)
+			{
+				carry[carried++] = vertices[count - 2];
+			}
+			carry[carried++] = vertices[count - 2];
+			carry[carried++] = vertices[count - 1];
+			break;
+		case GL_TRIANGLE_FAN:
+			carry[carried++] = vertices[0];
+			carry[carried++] = vertices[count - 1];
+			break;
+		default:
+			break;
+	}
+	
+	ftglesDrawVertices(c, prim, drawn);
+	
+	/* Incomplete primitives left over from a split are moved to the front. */
+	unsigned int leftover = count - drawn;
+	if (leftover)
+	{
+		memmove(vertices, vertices + drawn, leftover * sizeof(ftglesVertex_t));
+		if (prim == GL_QUADS)
 		{
-			glVertexPointer(vertexArraySize, vertexArrayType, 
-							vertexArrayStride, vertexArrayPointer);	
+			c->quadTextures[0] = c->quadTextures[drawn >> 2];
 		}
-		if (texCoordArrayEnabled)
+	}
+	
+	for (unsigned int i = 0; i < carried; ++i)
+	{
+		vertices[leftover + i] = carry[i];
+	}
+	c->currIndex = leftover + carried;
+}
+
+
+GLvoid ftglEnd() 
+{
+	ftglesContext *c = ftglesBatchCurrent();
+	
+	pthread_setspecific(ftglesBatchKey, NULL);
+	
+	if (ftglesDeferQuads(c) && c->primitive == GL_QUADS)
+	{
+		/* Drawn by ftglesEndSession, or recorded by ftglesEndCapture. */
+		return;
+	}
+	
+	if (c->loopSplit)
+	{
+		if (c->currIndex >= c->capacity)
 		{
-			glTexCoordPointer(texCoordArraySize, texCoordArrayType, 
-							  texCoordArrayStride, texCoordArrayPointer);
+			ftglesFlushVertices(c);
 		}
-		if (colorArrayEnabled)
+		c->vertices[c->currIndex++] = c->loopStart;
+		c->loopSplit = false;
+	}
+	
+	ftglesDrawVertices(c, c->primitive, c->currIndex);
+	
+	c->currIndex = 0;
+	c->primitive = 0;
+	
+	if (ftglesDeferQuads(c))
+	{
+		/* Go back to collecting quads for the rest of the session. */
+		ftglBegin(GL_QUADS);
+		pthread_setspecific(ftglesBatchKey, NULL);
+	}
+}
+
+
+GLvoid ftglesSaveTextState(ftglesTextState_t *state)
+{
+	const ftglesBackend_t *backend = ftglesCurrent()->backend;
+	backend->saveTextState(backend->userData, state);
+}
+
+
+GLvoid ftglesRestoreTextState(const ftglesTextState_t *state)
+{
+	const ftglesBackend_t *backend = ftglesCurrent()->backend;
+	backend->restoreTextState(backend->userData, state);
+}
+
+
+GLvoid ftglesLoadCurrentColor()
+{
+	ftglesContext *c = ftglesCurrent();
+	GLfloat colors[4];
+	
+	c->backend->currentColor(c->backend->userData, colors);
+	ftglColor4f(colors[0], colors[1], colors[2], colors[3]);
+}
+
+
+GLvoid ftglesGetColor(GLubyte rgba[4])
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	memcpy(rgba, c->currVertex.rgba, 4);
+}
+
+
+GLsizei ftglesVertexStride(unsigned int format)
+{
+	GLsizei stride;
+	
+	switch (format & ~FTGLES_VERTEX_UNIFORM_COLOR)
+	{
+		case FTGLES_VERTEX_COMPACT:
+			stride = 2 * sizeof(GLfloat) + 2 * sizeof(GLshort) + 4;
+			break;
+		case FTGLES_VERTEX_SHORT:
+			stride = 4 * sizeof(GLshort) + 4;
+			break;
+		default:
+			return sizeof(ftglesVertex_t);
+	}
+	
+	if (format & FTGLES_VERTEX_UNIFORM_COLOR)
+	{
+		stride -= 4;
+	}
+	return stride;
+}
+
+
+GLvoid ftglesSetVertexFormat(unsigned int format)
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	if ((format & ~FTGLES_VERTEX_UNIFORM_COLOR) == FTGLES_VERTEX_FLOAT)
+	{
+		/* The full format always carries colour. */
+		format = FTGLES_VERTEX_FLOAT;
+	}
+	
+	if (format == c->format)
+	{
+		return;
+	}
+	
+	if (ftglesDeferQuads(c) && c->primitive == GL_QUADS && c->currIndex && !c->capture)
+	{
+		/* Quads already collected are drawn in the format they were made in. */
+		ftglesDrawVertices(c, c->primitive, c->currIndex);
+		c->currIndex = 0;
+	}
+	
+	c->format = format;
+}
+
+
+unsigned int ftglesGetVertexFormat()
+{
+	return ftglesCurrent()->format;
+}
+
+
+GLvoid ftglesSetBackend(const ftglesBackend_t *backend)
+{
+	ftglesCurrent()->backend = backend ? backend : &ftglesGLES1Backend;
+}
+
+
+const ftglesBackend_t *ftglesGetBackend()
+{
+	return ftglesCurrent()->backend;
+}
+
+
+GLuint ftglesCreateTexture()
+{
+	const ftglesBackend_t *backend = ftglesCurrent()->backend;
+	return backend->createTexture(backend->userData);
+}
+
+
+GLvoid ftglesTextureImage(GLuint texture, GLsizei width, GLsizei height, const GLvoid *pixels)
+{
+	const ftglesBackend_t *backend = ftglesCurrent()->backend;
+	backend->textureImage(backend->userData, texture, width, height, pixels);
+}
+
+
+GLvoid ftglesTextureSubImage(GLuint texture, GLint x, GLint y,
+							 GLsizei width, GLsizei height, const GLvoid *pixels)
+{
+	const ftglesBackend_t *backend = ftglesCurrent()->backend;
+	backend->textureSubImage(backend->userData, texture, x, y, width, height, pixels);
+}
+
+
+GLvoid ftglesDeleteTextures(GLsizei n, const GLuint *textures)
+{
+	const ftglesBackend_t *backend = ftglesCurrent()->backend;
+	backend->deleteTextures(backend->userData, n, textures);
+}
+
+
+GLint ftglesMaxTextureSize()
+{
+	const ftglesBackend_t *backend = ftglesCurrent()->backend;
+	return backend->maxTextureSize(backend->userData);
+}
+
+
+GLvoid ftglesAlphaTest(GLfloat threshold)
+{
+	const ftglesBackend_t *backend = ftglesCurrent()->backend;
+	backend->alphaTest(backend->userData, threshold);
+}
+
+
+GLvoid ftglesFlush()
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	if (c->primitive == GL_QUADS && c->currIndex >= 4 && !c->capture)
+	{
+		ftglesFlushVertices(c);
+	}
+}
+
+
+GLboolean ftglesBatchFits(unsigned int vertices)
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	return c->capture || vertices <= c->capacity - c->currIndex;
+}
+
+
+GLvoid ftglesBeginSession()
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	if (c->session.depth++)
+	{
+		return;
+	}
+	
+	ftglesSaveTextState(&c->session.textState);
+	c->backend->beginDraw(c->backend->userData, &c->session.clientState, c->vertices);
+	
+	ftglesLoadCurrentColor();
+	
+	c->primitive = 0;
+	ftglBegin(GL_QUADS);
+}
+
+
+GLvoid ftglesEndSession()
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	if (c->session.depth != 1)
+	{
+		if (c->session.depth)
 		{
-			glColorPointer(colorArraySize, colorArrayType, 
-						   colorArrayStride, colorArrayPointer);
+			c->session.depth--;
 		}
+		return;
 	}
 	
-	if (!vertexArrayEnabled)
+	/* Still inside the session, so the draw uses the session's client state. */
+	ftglesDrawVertices(c, c->primitive, c->currIndex);
+	c->currIndex = 0;
+	c->primitive = 0;
+	c->session.depth = 0;
+	
+	c->backend->endDraw(c->backend->userData, &c->session.clientState);
+	ftglesRestoreTextState(&c->session.textState);
+}
+
+
+GLboolean ftglesInSession()
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	return c->session.depth > 0;
+}
+
+
+GLvoid ftglesBeginCapture(ftglesCapture_t *capture)
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	if (c->primitive && c->currIndex)
 	{
-		glDisableClientState(GL_VERTEX_ARRAY);
+		/* Anything a session collected so far is not part of the capture. */
+		ftglesDrawVertices(c, c->primitive, c->currIndex);
+		c->currIndex = 0;
 	}
 	
-	if (!texCoordArrayEnabled)
+	capture->count = 0;
+	capture->previous = c->capture;
+	c->capture = capture;
+	
+	c->primitive = 0;
+	ftglBegin(GL_QUADS);
+}
+
+
+GLvoid ftglesEndCapture()
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	if (!c->capture)
 	{
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		return;
 	}
 	
-	if (!colorArrayEnabled)
+	ftglesDrawVertices(c, c->primitive, c->currIndex);
+	c->capture = (ftglesCapture_t *)c->capture->previous;
+	c->currIndex = 0;
+	c->primitive = 0;
+	
+	if (ftglesDeferQuads(c))
 	{
-		glDisableClientState(GL_COLOR_ARRAY);
+		ftglBegin(GL_QUADS);
 	}
 }
 
 
+GLboolean ftglesInCapture()
+{
+	ftglesContext *c = ftglesCurrent();
+	
+	return c->capture != NULL;
+}
+
+
+GLvoid ftglesFreeCapture(ftglesCapture_t *capture)
+{
+	free(capture->vertices);
+	free(capture->textures);
+	capture->vertices = NULL;
+	capture->textures = NULL;
+	capture->count = capture->capacity = 0;
+}
+
+
+GLvoid ftglesSubmitQuads(const ftglesVertex_t *vertices, const GLuint *textures,
+						 unsigned int count, GLfloat dx, GLfloat dy)
+{
+	ftglesContext *c = ftglesCurrent();
+	const GLubyte *rgba = c->currVertex.rgba;
+	
+	for (unsigned int i = 0; i < count; i += 4)
+	{
+		if (c->currIndex + 4 > c->capacity)
+		{
+			ftglesFlushVertices(c);
+		}
+		
+		unsigned int index = c->currIndex;
+		ftglesVertex_t *out = c->vertices + index;
+		
+		for (unsigned int v = 0; v < 4; ++v)
+		{
+			out[v] = vertices[i + v];
+			out[v].xyz[0] += dx;
+			out[v].xyz[1] += dy;
+			out[v].rgba[0] = rgba[0];
+			out[v].rgba[1] = rgba[1];
+			out[v].rgba[2] = rgba[2];
+			out[v].rgba[3] = rgba[3];
+		}
+		
+		c->quadTextures[index >> 2] = textures[i >> 2];
+		c->currIndex += 4;
+	}
+	
+	c->textured = true;
+}
+
+
 GLvoid ftglError(const char *source)
 {
 	GLenum error = glGetError();
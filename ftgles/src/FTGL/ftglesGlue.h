@@ -33,10 +33,220 @@
 
 #define GL_QUADS 888
 
+/*
+ * Vertex capacity of a context created with a capacity of zero, and of
+ * the default context each thread gets.
+ */
+#define FTGLES_GLUE_DEFAULT_VERTICES 32768
+
+/*
+ * Batching state: vertex arrays, the current primitive, session and
+ * capture. Each thread draws into its current context, so threads with
+ * their own contexts can build text at the same time.
+ */
+typedef struct ftglesContext ftglesContext;
+
+typedef struct 
+{
+	float xyz[3];
+	float st[2];
+	GLubyte rgba[4];
+} ftglesVertex_t;
+
+/*
+ * Vertex layouts a batch can be handed to the backend in.
+ *
+ * FTGLES_VERTEX_FLOAT    float x, y, z; float s, t; ubyte rgba. 24 bytes.
+ * FTGLES_VERTEX_COMPACT  float x, y; short s, t; ubyte rgba. 16 bytes.
+ * FTGLES_VERTEX_SHORT    short x, y; short s, t; ubyte rgba. 12 bytes.
+ *
+ * Compact texture coordinates are scaled by FTGLES_TEXCOORD_SCALE. Short
+ * positions are rounded to the nearest whole unit, which suits texture font
+ * quads drawn in pixel units; text drawn at fractional positions or with
+ * subpixel glyphs moves by up to half a unit, so use a float layout for it.
+ * FTGLES_VERTEX_UNIFORM_COLOR can be or'd into a
+ * compact layout to drop the colour from each vertex; the batch is then
+ * drawn in the colour of its first vertex.
+ */
+#define FTGLES_VERTEX_FLOAT			0
+#define FTGLES_VERTEX_COMPACT		1
+#define FTGLES_VERTEX_SHORT			2
+#define FTGLES_VERTEX_UNIFORM_COLOR	0x10
+
+#define FTGLES_TEXCOORD_SCALE 32767.0f
+
+/*
+ * A batch as handed to the backend. vertices is always the full batch;
+ * packed holds the same vertices in format, unless that is
+ * FTGLES_VERTEX_FLOAT.
+ */
+typedef struct
+{
+	const ftglesVertex_t *vertices;
+	const GLvoid *packed;
+	unsigned int format;
+	GLsizei stride;
+} ftglesVertexArray_t;
+
+/*
+ * A recorded GL_QUADS stream: four vertices and one texture per quad.
+ * If emit is set, quads are passed to it as each batch fills instead of
+ * being stored, and only count is kept.
+ */
+typedef struct
+{
+	ftglesVertex_t *vertices;
+	GLuint *textures;
+	unsigned int count;
+	unsigned int capacity;
+	
+	GLvoid (*emit)(void *userData, const ftglesVertex_t *vertices,
+				   const GLuint *textures, unsigned int count);
+	void *userData;
+	
+	/* The capture that was active when this one began. */
+	void *previous;
+} ftglesCapture_t;
+
+/*
+ * Server state changed by text rendering, as saved by ftglesSaveTextState.
+ */
+typedef struct
+{
+	GLboolean blendEnabled;
+	GLboolean texture2DEnabled;
+	GLint blendSrc;
+	GLint blendDst;
+	GLboolean alphaTestEnabled;
+	GLint alphaFunc;
+	GLfloat alphaRef;
+} ftglesTextState_t;
+
+/*
+ * Client array state saved by a backend around drawing.
+ */
+typedef struct
+{
+	GLboolean vertexArrayEnabled;
+	GLboolean texCoordArrayEnabled;
+	GLboolean colorArrayEnabled;
+	
+	GLvoid * vertexArrayPointer;
+	GLvoid * texCoordArrayPointer;
+	GLvoid * colorArrayPointer;
+	
+	GLint vertexArrayType, texCoordArrayType, colorArrayType;
+	GLint vertexArraySize, texCoordArraySize, colorArraySize;
+	GLsizei vertexArrayStride, texCoordArrayStride, colorArrayStride;
+	
+	GLboolean resetPointers;
+} ftglesClientState_t;
+
+/*
+ * What the glue draws with. Batches arrive finished: quads as triangle
+ * indices into the context's vertex array, anything else as a primitive
+ * over the first count vertices. Drawing happens between beginDraw and
+ * endDraw, which a session calls once for all of its batches. A texture
+ * of 0 means the batch is untextured. Font textures are single channel
+ * alpha, and are created and filled through the backend too.
+ */
+typedef struct
+{
+	void *userData;
+	
+	GLvoid (*beginDraw)(void *userData, ftglesClientState_t *state, const ftglesVertex_t *vertices);
+	GLvoid (*endDraw)(void *userData, const ftglesClientState_t *state);
+	GLvoid (*drawElements)(void *userData, const ftglesVertexArray_t *array,
+						   const GLushort *indices, GLsizei count, GLuint texture);
+	GLvoid (*drawArrays)(void *userData, GLenum prim, const ftglesVertexArray_t *array,
+						 GLsizei count, GLuint texture);
+	
+	GLvoid (*saveTextState)(void *userData, ftglesTextState_t *state);
+	GLvoid (*restoreTextState)(void *userData, const ftglesTextState_t *state);
+	GLvoid (*currentColor)(void *userData, GLfloat rgba[4]);
+	
+	GLuint (*createTexture)(void *userData);
+	GLvoid (*textureImage)(void *userData, GLuint texture, GLsizei width, GLsizei height,
+						   const GLvoid *pixels);
+	GLvoid (*textureSubImage)(void *userData, GLuint texture, GLint x, GLint y,
+							  GLsizei width, GLsizei height, const GLvoid *pixels);
+	GLvoid (*deleteTextures)(void *userData, GLsizei n, const GLuint *textures);
+	GLint (*maxTextureSize)(void *userData);
+	GLvoid (*alphaTest)(void *userData, GLfloat threshold);
+} ftglesBackend_t;
+
+/*
+ * Totals kept by the recording backend, and the texture of its last draw.
+ */
+typedef struct
+{
+	unsigned int draws;
+	GLuint texture;
+	unsigned int vertices;
+	unsigned int indices;
+	unsigned long vertexBytes;
+	unsigned int stateSaves;
+	unsigned int textures;
+	unsigned int uploads;
+	unsigned long uploadBytes;
+	GLfloat alphaTest;
+} ftglesRecording_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 	
+	/*
+	 * Create a context holding up to maxVertices vertices per batch, or
+	 * FTGLES_GLUE_DEFAULT_VERTICES if zero. The capacity is clamped to
+	 * the 65536 vertices a GLushort index can reach. Returns NULL if the
+	 * arrays could not be allocated.
+	 */
+	extern ftglesContext *ftglesCreateContext(unsigned int maxVertices);
+	
+	/*
+	 * Destroy a context. It must not be current on any other thread.
+	 */
+	extern GLvoid ftglesDestroyContext(ftglesContext *context);
+	
+	/*
+	 * Make a context current for the calling thread. NULL goes back to the
+	 * thread's default context.
+	 */
+	extern GLvoid ftglesMakeCurrent(ftglesContext *context);
+	
+	extern ftglesContext *ftglesGetCurrentContext();
+	
+	/*
+	 * The backend every context starts with.
+	 */
+	extern const ftglesBackend_t ftglesGLES1Backend;
+	
+	/*
+	 * Fill in a backend that makes no GL calls and only counts into
+	 * recording, for measuring text rendering without a GPU.
+	 */
+	extern GLvoid ftglesInitRecordingBackend(ftglesBackend_t *backend, ftglesRecording_t *recording);
+	
+	/*
+	 * Set the backend of the current context. NULL restores the GLES1
+	 * backend. The backend is not copied and must outlive its use.
+	 */
+	extern GLvoid ftglesSetBackend(const ftglesBackend_t *backend);
+	
+	extern const ftglesBackend_t *ftglesGetBackend();
+	
+	/*
+	 * Set the layout the current context hands batches to the backend in,
+	 * one of the FTGLES_VERTEX_ values. Quads a session has already
+	 * collected are drawn first, in the old layout.
+	 */
+	extern GLvoid ftglesSetVertexFormat(unsigned int format);
+	
+	extern unsigned int ftglesGetVertexFormat();
+	
+	extern GLsizei ftglesVertexStride(unsigned int format);
+	
 	extern GLvoid ftglBegin( GLenum prim );
 	
 	extern GLvoid ftglVertex3f( float x, float y, float z );
@@ -44,13 +254,107 @@ extern "C" {
 	extern GLvoid ftglVertex2f( float x, float y);
 	
 	extern GLvoid ftglColor4f( GLfloat r, GLfloat g, GLfloat b, GLfloat a );
+	
+	extern GLvoid ftglColor4ub( GLubyte r, GLubyte g, GLubyte b, GLubyte a );
 		
 	extern GLvoid ftglTexCoord2f( GLfloat s, GLfloat t );
 	
+	/*
+	 * Set the texture for the following vertices. Binds are deferred until
+	 * the batch is drawn. GL_QUADS batches are split by texture and drawn
+	 * with one call per texture; other primitives use the last texture set.
+	 */
+	extern GLvoid ftglBindTexture( GLuint texture );
+	
 	extern GLvoid ftglEnd();
 	
 	extern GLvoid ftglError(const char *source);
 	
+	/*
+	 * Enables blending and texturing for text, saving what was there.
+	 */
+	extern GLvoid ftglesSaveTextState(ftglesTextState_t *state);
+	
+	extern GLvoid ftglesRestoreTextState(const ftglesTextState_t *state);
+	
+	/*
+	 * Make the backend's current colour the colour of following vertices.
+	 */
+	extern GLvoid ftglesLoadCurrentColor();
+	
+	/*
+	 * Read back the colour of following vertices.
+	 */
+	extern GLvoid ftglesGetColor(GLubyte rgba[4]);
+	
+	/*
+	 * Alpha texture management, through the current backend.
+	 */
+	extern GLuint ftglesCreateTexture();
+	
+	extern GLvoid ftglesTextureImage(GLuint texture, GLsizei width, GLsizei height, const GLvoid *pixels);
+	
+	extern GLvoid ftglesTextureSubImage(GLuint texture, GLint x, GLint y,
+										GLsizei width, GLsizei height, const GLvoid *pixels);
+	
+	extern GLvoid ftglesDeleteTextures(GLsizei n, const GLuint *textures);
+	
+	/*
+	 * The largest texture dimension the backend supports.
+	 */
+	extern GLint ftglesMaxTextureSize();
+	
+	/*
+	 * Only draw fragments whose alpha is at least the threshold, or draw
+	 * every fragment again with 0. Distance field text is cut at 0.5. The
+	 * setting is saved and restored with the text state.
+	 */
+	extern GLvoid ftglesAlphaTest(GLfloat threshold);
+	
+	/*
+	 * Draw the complete quads of the open GL_QUADS batch now, so a texture
+	 * they use can be overwritten. The batch stays open. Does nothing while
+	 * capturing.
+	 */
+	extern GLvoid ftglesFlush();
+	
+	/*
+	 * Whether the open batch takes this many more vertices without drawing
+	 * any of them to make room. Always true while capturing.
+	 */
+	extern GLboolean ftglesBatchFits(unsigned int vertices);
+	
+	/*
+	 * Sessions save GL state once, collect every GL_QUADS batch until the
+	 * outermost ftglesEndSession, and draw them together. Other primitives
+	 * are still drawn in order at their ftglEnd. Sessions nest.
+	 */
+	extern GLvoid ftglesBeginSession();
+	
+	extern GLvoid ftglesEndSession();
+	
+	extern GLboolean ftglesInSession();
+	
+	/*
+	 * Record every GL_QUADS batch into a capture instead of drawing it,
+	 * until ftglesEndCapture. The capture is grown as needed; release it
+	 * with ftglesFreeCapture. Captures nest.
+	 */
+	extern GLvoid ftglesBeginCapture(ftglesCapture_t *capture);
+	
+	extern GLvoid ftglesEndCapture();
+	
+	extern GLboolean ftglesInCapture();
+	
+	extern GLvoid ftglesFreeCapture(ftglesCapture_t *capture);
+	
+	/*
+	 * Append captured quads to the current GL_QUADS batch, offset by dx, dy
+	 * and in the current colour.
+	 */
+	extern GLvoid ftglesSubmitQuads(const ftglesVertex_t *vertices, const GLuint *textures,
+									unsigned int count, GLfloat dx, GLfloat dy);
+	
 #ifdef __cplusplus
 }
 #endif
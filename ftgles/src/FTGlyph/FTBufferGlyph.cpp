@@ -25,6 +25,7 @@
 
 #include "config.h"
 
+#include <math.h>
 #include <string>
 
 #include "FTGL/ftgles.h"
@@ -93,26 +94,44 @@ const FTPoint& FTBufferGlyphImpl::RenderImpl(const FTPoint& pen, int renderMode)
     if(has_bitmap)
     {
         FTPoint pos(buffer->Pos() + pen + corner);
-        int dx = (int)(pos.Xf() + 0.5f);
-        int dy = buffer->Height() - (int)(pos.Yf() + 0.5f);
-        unsigned char * dest = buffer->Pixels() + dx + dy * buffer->Width();
-
-        for(int y = 0; y < bitmap.rows; y++)
+        // floorf, so glyphs off the left or top edge round like the rest
+        int dx = (int)floorf(pos.Xf() + 0.5f);
+        int dy = buffer->Height() - (int)floorf(pos.Yf() + 0.5f);
+
+        // Clip the bitmap to the buffer once, rather than every pixel
+        int left = dx < 0 ? -dx : 0;
+        int top = dy < 0 ? -dy : 0;
+        int right = dx + (int)bitmap.width > buffer->Width()
+                  ? buffer->Width() - dx : (int)bitmap.width;
+        int bottom = dy + (int)bitmap.rows > buffer->Height()
+                   ? buffer->Height() - dy : (int)bitmap.rows;
+
+        if(left >= right || top >= bottom)
         {
-            // FIXME: change the loop bounds instead of doing this test
-            if(y + dy < 0 || y + dy >= buffer->Height()) continue;
+            return advance;
+        }
 
-            for(int x = 0; x < bitmap.width; x++)
-            {
-                if(x + dx < 0 || x + dx >= buffer->Width()) continue;
+        buffer->Dirty(dx + left, dy + top, right - left, bottom - top);
 
-                unsigned char p = pixels[y * bitmap.pitch + x];
+        const int stride = buffer->Width();
+        const int count = right - left;
+        const unsigned char *src = pixels + top * bitmap.pitch + left;
+        unsigned char *dest = buffer->Pixels() + (dy + top) * stride
+                            + dx + left;
 
-                if(p)
-                {
-                    dest[y * buffer->Width() + x] = p;
-                }
+        for(int y = top; y < bottom; y++)
+        {
+            // Overlapping glyphs, such as kerned pairs, keep the higher
+            // coverage. A plain loop the compiler can vectorise.
+            for(int x = 0; x < count; x++)
+            {
+                unsigned char p = src[x];
+                unsigned char d = dest[x];
+                dest[x] = p > d ? p : d;
             }
+
+            src += bitmap.pitch;
+            dest += stride;
         }
     }
 
@@ -64,6 +64,10 @@ const FTPoint& FTPolygonGlyph::Render(const FTPoint& pen, int renderMode)
 FTPolygonGlyphImpl::FTPolygonGlyphImpl(FT_GlyphSlot glyph, float _outset,
                                        bool useDisplayList)
 :   FTGlyphImpl(glyph),
+    vertices(NULL),
+    indices(NULL),
+    vertexCount(0),
+    indexCount(0),
     glList(0)
 {
     if(ft_glyph_format_outline != glyph->format)
@@ -72,12 +76,10 @@ FTPolygonGlyphImpl::FTPolygonGlyphImpl(FT_GlyphSlot glyph, float _outset,
         return;
     }
 
-    vectoriser = new FTVectoriser(glyph);
+    FTVectoriser vectoriser(glyph);
 
-    if((vectoriser->ContourCount() < 1) || (vectoriser->PointCount() < 3))
+    if((vectoriser.ContourCount() < 1) || (vectoriser.PointCount() < 3))
     {
-        delete vectoriser;
-        vectoriser = NULL;
         return;
     }
 
@@ -101,56 +103,113 @@ FTPolygonGlyphImpl::FTPolygonGlyphImpl(FT_GlyphSlot glyph, float _outset,
      * as the iPhone is not efficient enough to handle a tesselation
      * on each frame.
      */
-    if (vectoriser)
-        vectoriser->MakeMesh(1.0, 1, outset);
+    vectoriser.MakeMesh(1.0, 1, outset);
+    MakeTriangles(vectoriser.GetMesh());
 }
 
 
 FTPolygonGlyphImpl::~FTPolygonGlyphImpl()
 {
-    if (vectoriser)
-    {
-        delete vectoriser;
-    }
+    delete [] vertices;
+    delete [] indices;
 }   
 
 
-const FTPoint& FTPolygonGlyphImpl::RenderImpl(const FTPoint& pen,
-                                              int renderMode)
+void FTPolygonGlyphImpl::MakeTriangles(const FTMesh *mesh)
 {
-    glTranslatef(pen.Xf(), pen.Yf(), pen.Zf());
-    if (vectoriser)
+    const unsigned int tesselations = mesh->TesselationCount();
+
+    for(unsigned int t = 0; t < tesselations; ++t)
     {
-        DoRender();
+        unsigned int points = mesh->Tesselation(t)->PointCount();
+
+        if(points >= 3)
+        {
+            vertexCount += points;
+            indexCount += (mesh->Tesselation(t)->PolygonType() == GL_TRIANGLES)
+                          ? points - points % 3 : (points - 2) * 3;
+        }
+    }
+
+    if(!indexCount)
+    {
+        vertexCount = 0;
+        return;
     }
-    glTranslatef(-pen.Xf(), -pen.Yf(), -pen.Zf());
-    return advance;
-}
 
+    vertices = new float[vertexCount * 4];
+    indices = new unsigned short[indexCount];
 
-void FTPolygonGlyphImpl::DoRender()
-{
-    GLfloat colors[4];
-    
-    const FTMesh *mesh = vectoriser->GetMesh();
+    float *v = vertices;
+    unsigned short *i = indices;
+    unsigned short base = 0;
 
-    for(unsigned int t = 0; t < mesh->TesselationCount(); ++t)
+    for(unsigned int t = 0; t < tesselations; ++t)
     {
         const FTTesselation* subMesh = mesh->Tesselation(t);
-        unsigned int polygonType = subMesh->PolygonType();
-        
-        glGetFloatv(GL_CURRENT_COLOR, colors);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        
-        ftglBegin(polygonType);
-        ftglColor4f(colors[0], colors[1], colors[2], colors[3]);
-        for(unsigned int i = 0; i < subMesh->PointCount(); ++i)
+        unsigned int points = subMesh->PointCount();
+
+        if(points < 3)
         {
-            FTPoint point = subMesh->Point(i);
-            ftglTexCoord2f(point.Xf() / hscale, point.Yf() / vscale);
-            ftglVertex3f(point.Xf() / 64.0f, point.Yf() / 64.0f, 0.0f);
+            continue;
         }
-        ftglEnd();
+
+        for(unsigned int p = 0; p < points; ++p)
+        {
+            FTPoint point = subMesh->Point(p);
+            *v++ = point.Xf() / 64.0f;
+            *v++ = point.Yf() / 64.0f;
+            *v++ = point.Xf() / hscale;
+            *v++ = point.Yf() / vscale;
+        }
+
+        switch(subMesh->PolygonType())
+        {
+            case GL_TRIANGLE_STRIP:
+                // Every other triangle is flipped to keep the winding
+                for(unsigned int p = 0; p + 2 < points; ++p)
+                {
+                    *i++ = base + p + (p & 1);
+                    *i++ = base + p + 1 - (p & 1);
+                    *i++ = base + p + 2;
+                }
+                break;
+            case GL_TRIANGLE_FAN:
+                for(unsigned int p = 1; p + 1 < points; ++p)
+                {
+                    *i++ = base;
+                    *i++ = base + p;
+                    *i++ = base + p + 1;
+                }
+                break;
+            default:
+                for(unsigned int p = 0; p + 2 < points; p += 3)
+                {
+                    *i++ = base + p;
+                    *i++ = base + p + 1;
+                    *i++ = base + p + 2;
+                }
+                break;
+        }
+
+        base += points;
     }
 }
 
+
+const FTPoint& FTPolygonGlyphImpl::RenderImpl(const FTPoint& pen,
+                                              int renderMode)
+{
+    const float x = pen.Xf(), y = pen.Yf(), z = pen.Zf();
+
+    // The font has begun a GL_TRIANGLES batch; the pen goes into the
+    // vertices so the whole string stays in it.
+    for(unsigned int n = 0; n < indexCount; ++n)
+    {
+        const float *v = vertices + indices[n] * 4;
+        ftglTexCoord2f(v[2], v[3]);
+        ftglVertex3f(v[0] + x, v[1] + y, z);
+    }
+
+    return advance;
+}
@@ -29,7 +29,7 @@
 
 #include "FTGlyphImpl.h"
 
-class FTVectoriser;
+class FTMesh;
 
 class FTPolygonGlyphImpl : public FTGlyphImpl
 {
@@ -45,17 +45,24 @@ class FTPolygonGlyphImpl : public FTGlyphImpl
 
     private:
         /**
-         * Private rendering method.
+         * Convert the tesselated mesh into one indexed triangle list.
          */
-        void DoRender();
+        void MakeTriangles(const FTMesh *mesh);
 
         /**
          * Private rendering variables.
          */
         unsigned int hscale, vscale;
-        FTVectoriser *vectoriser;
         float outset;
 
+        /**
+         * The glyph's triangles: x, y, s, t per vertex, three indices
+         * per triangle.
+         */
+        float *vertices;
+        unsigned short *indices;
+        unsigned int vertexCount, indexCount;
+
         /**
          * OpenGL display list
          */
@@ -32,6 +32,7 @@
 
 #include "FTInternals.h"
 #include "FTTextureGlyphImpl.h"
+#include "../FTFont/FTTextureFontImpl.h"
 
 
 //
@@ -40,8 +41,10 @@
 
 
 FTTextureGlyph::FTTextureGlyph(FT_GlyphSlot glyph, int id, int xOffset,
-                               int yOffset, int width, int height) :
-    FTGlyph(new FTTextureGlyphImpl(glyph, id, xOffset, yOffset, width, height))
+                               int yOffset, int width, int height,
+                               bool upload) :
+    FTGlyph(new FTTextureGlyphImpl(glyph, id, xOffset, yOffset, width, height,
+                                   upload))
 {}
 
 
@@ -61,19 +64,32 @@ const FTPoint& FTTextureGlyph::Render(const FTPoint& pen, int renderMode)
 //
 
 
-GLint FTTextureGlyphImpl::activeTextureID = 0;
-
 FTTextureGlyphImpl::FTTextureGlyphImpl(FT_GlyphSlot glyph, int id, int xOffset,
-                                       int yOffset, int width, int height)
+                                       int yOffset, int width, int height,
+                                       bool upload)
 :   FTGlyphImpl(glyph),
     destWidth(0),
     destHeight(0),
-    glTextureID(id)
+    glTextureID(id),
+    pageUsed(NULL),
+    renderCount(NULL),
+    scale(NULL),
+    variantFont(NULL),
+    owner(NULL),
+    glyphIndex(0),
+    charCode(0),
+    atlasOwner(-1)
 {
     /* FIXME: need to propagate the render mode all the way down to
      * here in order to get FT_RENDER_MODE_MONO aliased fonts.
      */
 
+    // Without a slot the image is set later, as for a cached glyph
+    if(!glyph)
+    {
+        return;
+    }
+
     err = FT_Render_Glyph(glyph, FT_RENDER_MODE_NORMAL);
     if(err || glyph->format != ft_glyph_format_bitmap)
     {
@@ -82,15 +98,22 @@ FTTextureGlyphImpl::FTTextureGlyphImpl(FT_GlyphSlot glyph, int id, int xOffset,
 
     FT_Bitmap      bitmap = glyph->bitmap;
 
-    destWidth  = bitmap.width;
-    destHeight = bitmap.rows;
-	
-    if (destWidth && destHeight)
+    if (upload && bitmap.width && bitmap.rows)
     {
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-		glBindTexture(GL_TEXTURE_2D, glTextureID);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, xOffset, yOffset, destWidth, destHeight, GL_ALPHA, GL_UNSIGNED_BYTE, bitmap.buffer);
+        ftglesTextureSubImage(glTextureID, xOffset, yOffset, bitmap.width, bitmap.rows, bitmap.buffer);
     }
+
+    Image(FTPoint(glyph->bitmap_left, glyph->bitmap_top), bitmap.width,
+          bitmap.rows, xOffset, yOffset, width, height);
+}
+
+
+void FTTextureGlyphImpl::Image(const FTPoint& topLeft, int imageWidth,
+                               int imageHeight, int xOffset, int yOffset,
+                               int width, int height)
+{
+    destWidth  = imageWidth;
+    destHeight = imageHeight;
 //      0
 //      +----+
 //      |    |
@@ -103,7 +126,7 @@ FTTextureGlyphImpl::FTTextureGlyphImpl(FT_GlyphSlot glyph, int id, int xOffset,
     uv[1].X(static_cast<float>(xOffset + destWidth) / static_cast<float>(width));
     uv[1].Y(static_cast<float>(yOffset + destHeight) / static_cast<float>(height));
 
-    corner = FTPoint(glyph->bitmap_left, glyph->bitmap_top);
+    corner = topLeft;
 }
 
 
@@ -116,27 +139,84 @@ const FTPoint& FTTextureGlyphImpl::RenderImpl(const FTPoint& pen,
 {
     float dx, dy;
 	
-	glGetIntegerv(GL_TEXTURE_BINDING_2D, &activeTextureID);
-    if(activeTextureID != glTextureID)
+    if(pageUsed)
     {
-		glBindTexture(GL_TEXTURE_2D, (GLuint)glTextureID);
-        //activeTextureID = glTextureID;
+        *pageUsed = *renderCount;
     }
 	
-    dx = floor(pen.Xf() + corner.Xf());
-    dy = floor(pen.Yf() + corner.Yf());
+    if(variantFont && !scale)
+    {
+        // Round the pen to the nearest phase, carrying into the next pixel
+        float whole = floor(pen.Xf());
+        unsigned int phases = variants.size();
+        unsigned int phase = static_cast<unsigned int>((pen.Xf() - whole)
+                                                       * phases + 0.5f);
+        if(phase >= phases)
+        {
+            phase = 0;
+            whole += 1.0f;
+        }
+		
+        if(!variants[phase].made)
+        {
+            variantFont->MakeVariant(this, phase);
+        }
+		
+        const Variant& v = variants[phase];
+        if(v.pageUsed)
+        {
+            *v.pageUsed = *renderCount;
+        }
+		
+        ftglBindTexture(v.texture);
+		
+        dx = whole + v.corner.Xf();
+        dy = floor(pen.Yf() + v.corner.Yf());
+		
+        ftglTexCoord2f(v.uv[0].Xf(), v.uv[0].Yf());
+        ftglVertex2f(dx, dy);
+		
+        ftglTexCoord2f(v.uv[0].Xf(), v.uv[1].Yf());
+        ftglVertex2f(dx, dy - v.height);
+		
+        ftglTexCoord2f(v.uv[1].Xf(), v.uv[1].Yf());
+        ftglVertex2f(dx + v.width, dy - v.height);
+		
+        ftglTexCoord2f(v.uv[1].Xf(), v.uv[0].Yf());
+        ftglVertex2f(dx + v.width, dy);
+		
+        return advance;
+    }
+	
+	ftglBindTexture((GLuint)glTextureID);
+	
+    float w = destWidth, h = destHeight;
+	
+    if(scale)
+    {
+        // Scaled glyphs are not snapped to pixels; they have no fixed size
+        dx = (pen.Xf() + corner.Xf()) * *scale;
+        dy = (pen.Yf() + corner.Yf()) * *scale;
+        w *= *scale;
+        h *= *scale;
+    }
+    else
+    {
+        dx = floor(pen.Xf() + corner.Xf());
+        dy = floor(pen.Yf() + corner.Yf());
+    }
 	
 	ftglTexCoord2f(uv[0].Xf(), uv[0].Yf());
 	ftglVertex2f(dx, dy);
 	
 	ftglTexCoord2f(uv[0].Xf(), uv[1].Yf());
-	ftglVertex2f(dx, dy - destHeight);
+	ftglVertex2f(dx, dy - h);
 	
 	ftglTexCoord2f(uv[1].Xf(), uv[1].Yf());
-	ftglVertex2f(dx + destWidth, dy - destHeight);
+	ftglVertex2f(dx + w, dy - h);
 	
 	ftglTexCoord2f(uv[1].Xf(), uv[0].Yf());
-	ftglVertex2f(dx + destWidth, dy);
+	ftglVertex2f(dx + w, dy);
 	
     return advance;
 }
@@ -29,6 +29,10 @@
 
 #include "FTGlyphImpl.h"
 
+#include "FTVector.h"
+
+class FTTextureFontImpl;
+
 class FTTextureGlyphImpl : public FTGlyphImpl
 {
     friend class FTTextureGlyph;
@@ -36,7 +40,7 @@ class FTTextureGlyphImpl : public FTGlyphImpl
 
     protected:
         FTTextureGlyphImpl(FT_GlyphSlot glyph, int id, int xOffset,
-                           int yOffset, int width, int height);
+                           int yOffset, int width, int height, bool upload);
 
         virtual ~FTTextureGlyphImpl();
 
@@ -44,11 +48,20 @@ class FTTextureGlyphImpl : public FTGlyphImpl
 
     private:
         /**
-         * Reset the currently active texture to zero to get into a known
-         * state before drawing a string. This is to get round possible
-         * threading issues.
+         * Set where the glyph image is drawn and where it sits in its
+         * texture.
+         *
+         * @param topLeft  Vector from the pen position to the top left of
+         *                 the image.
+         * @param imageWidth  Image width.
+         * @param imageHeight  Image height.
+         * @param xOffset  The image's left edge in the texture.
+         * @param yOffset  The image's top edge in the texture.
+         * @param width  The texture width.
+         * @param height  The texture height.
          */
-        static void ResetActiveTexture() { activeTextureID = 0; }
+        void Image(const FTPoint& topLeft, int imageWidth, int imageHeight,
+                   int xOffset, int yOffset, int width, int height);
 
         /**
          * The width of the glyph 'image'
@@ -76,12 +89,53 @@ class FTTextureGlyphImpl : public FTGlyphImpl
         int glTextureID;
 
         /**
-         * The texture index of the currently active texture
-         *
-         * We keep track of the currently active texture to try to reduce the
-         * number of texture bind operations.
+         * Set by FTTextureFont: RenderImpl copies the font's render count
+         * into its page's last use, for least recently used eviction.
+         */
+        unsigned int *pageUsed;
+        const unsigned int *renderCount;
+
+        /**
+         * Set by FTTextureFont for distance field glyphs: the pen position
+         * and image are in reference size units and scaled by this when
+         * drawn.
+         */
+        const float *scale;
+
+        /**
+         * An image of the glyph rasterised a fraction of a pixel right of
+         * the pen, for subpixel positioning.
+         */
+        struct Variant
+        {
+            Variant() : made(false), texture(0), width(0), height(0),
+                        pageUsed(NULL) {}
+
+            bool made;
+            GLuint texture;
+            int width, height;
+            FTPoint corner;
+            FTPoint uv[2];
+            unsigned int *pageUsed;
+        };
+
+        /**
+         * Set by FTTextureFont for subpixel positioning: the font making
+         * the variants, the glyph to name as their owner, the glyph's face
+         * index, and a variant per phase, the first being the whole pixel
+         * image above.
+         */
+        FTTextureFontImpl *variantFont;
+        FTGlyph *owner;
+        unsigned int glyphIndex;
+        FTVector<Variant> variants;
+
+        /**
+         * Set by FTTextureFont: the character the glyph was made for, and
+         * the first of its owner records in the atlas, or -1.
          */
-        static GLint activeTextureID;
+        unsigned int charCode;
+        int atlasOwner;
 };
 
 #endif  //  __FTTextureGlyphImpl__
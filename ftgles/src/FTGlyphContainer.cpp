@@ -71,11 +71,34 @@ unsigned int FTGlyphContainer::FontIndex(const unsigned int charCode) const
 
 void FTGlyphContainer::Add(FTGlyph* tempGlyph, const unsigned int charCode)
 {
+    unsigned int index = charMap->GlyphListIndex(charCode);
+
+    // Reload of a removed glyph
+    if(index && !glyphs[index])
+    {
+        glyphs[index] = tempGlyph;
+        return;
+    }
+
     charMap->InsertIndex(charCode, glyphs.size());
     glyphs.push_back(tempGlyph);
 }
 
 
+void FTGlyphContainer::Remove(const FTGlyph* glyph,
+                              const unsigned int charCode)
+{
+    unsigned int index = charMap->GlyphListIndex(charCode);
+
+    // Slot 0 is the empty glyph for unmapped characters
+    if(index && glyphs[index] == glyph)
+    {
+        delete glyphs[index];
+        glyphs[index] = NULL;
+    }
+}
+
+
 const FTGlyph* const FTGlyphContainer::Glyph(const unsigned int charCode) const
 {
     unsigned int index = charMap->GlyphListIndex(charCode);
@@ -85,6 +85,16 @@ class FTGlyphContainer
          */
         void Add(FTGlyph* glyph, const unsigned int characterCode);
 
+        /**
+         * Removes and deletes a glyph. The character it was added for will
+         * read as not loaded, and a later Add reuses its slot. Nothing is
+         * done if the character holds another glyph.
+         *
+         * @param glyph  A glyph previously added to this list.
+         * @param characterCode  The char code the glyph was added for.
+         */
+        void Remove(const FTGlyph* glyph, const unsigned int characterCode);
+
         /**
          * Get a glyph from the glyph list
          *
@@ -118,6 +118,27 @@ struct _FTGLlayout
     FTGL::LayoutType type;
 };
 
+struct _FTGLsession
+{
+    FTTextSession *ptr;
+};
+
+struct _FTGLtextblock
+{
+    FTTextBlock *ptr;
+};
+
+struct _FTGLatlas
+{
+    FTAtlasManager *ptr;
+};
+
+struct _FTGLbitmaprenderer
+{
+    FTBitmapRenderer *ptr;
+    FTGLfont font;
+};
+
 FTGL_END_C_DECLS
 
 #endif  //__FTINTERNALS_H__
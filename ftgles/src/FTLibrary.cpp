@@ -45,6 +45,8 @@ FTLibrary::~FTLibrary()
         library= 0;
     }
 
+    pthread_mutex_destroy(&mutex);
+
 //  if(manager != 0)
 //  {
 //      FTC_Manager_Done(manager);
@@ -59,6 +61,7 @@ FTLibrary::FTLibrary()
 :   library(0),
     err(0)
 {
+    pthread_mutex_init(&mutex, NULL);
     Initialise();
 }
 
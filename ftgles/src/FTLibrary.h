@@ -26,6 +26,8 @@
 #ifndef     __FTLibrary__
 #define     __FTLibrary__
 
+#include <pthread.h>
+
 #include "ft2build.h"
 #include FT_FREETYPE_H
 //#include FT_CACHE_H
@@ -75,6 +77,15 @@ class FTLibrary
          */
         FT_Error Error() const { return err; }
 
+        /**
+         * Serialise the calls FreeType needs serialised across threads,
+         * opening and closing faces. Each face is then only used by the
+         * thread holding the font it belongs to.
+         */
+        void Lock() const { pthread_mutex_lock(&mutex); }
+
+        void Unlock() const { pthread_mutex_unlock(&mutex); }
+
         /**
          * Destructor
          *
@@ -117,6 +128,8 @@ class FTLibrary
          */
         FT_Error err;
 
+        mutable pthread_mutex_t mutex;
+
 };
 
 #endif  //  __FTLibrary__
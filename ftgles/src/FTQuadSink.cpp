@@ -0,0 +1,143 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#include "config.h"
+
+#include "FTInternals.h"
+
+
+//
+//  FTQuadSink
+//
+
+
+FTQuadSink::~FTQuadSink()
+{}
+
+
+//
+//  FTQuadBuffer
+//
+
+
+FTQuadBuffer::FTQuadBuffer(FTGL::FTGLquad* quads, unsigned int size)
+:   buffer(quads),
+    capacity(size),
+    needed(0)
+{}
+
+
+void FTQuadBuffer::Quads(const FTGL::FTGLquad* quads, unsigned int count)
+{
+    if(needed < capacity)
+    {
+        unsigned int n = capacity - needed;
+        if(n > count)
+        {
+            n = count;
+        }
+        memcpy(buffer + needed, quads, n * sizeof(FTGL::FTGLquad));
+    }
+
+    needed += count;
+}
+
+
+unsigned int FTQuadBuffer::Count() const
+{
+    return needed < capacity ? needed : capacity;
+}
+
+
+unsigned int FTQuadBuffer::Needed() const
+{
+    return needed;
+}
+
+
+void FTQuadBuffer::Reset()
+{
+    needed = 0;
+}
+
+
+//
+//  C API
+//
+
+
+/*
+ * Forwards quads to a C callback.
+ */
+class FTQuadCallbackSink : public FTQuadSink
+{
+    public:
+        FTQuadCallbackSink(FTGL::FTGLquadCallback cb, void* d)
+        :   callback(cb),
+            data(d)
+        {}
+
+        virtual void Quads(const FTGL::FTGLquad* quads, unsigned int count)
+        {
+            callback(quads, count, data);
+        }
+
+    private:
+        FTGL::FTGLquadCallback callback;
+        void* data;
+};
+
+
+FTGL_BEGIN_C_DECLS
+
+unsigned int ftglRenderFontToQuads(FTGLfont *f, const char *string,
+                                   float x, float y, FTGLquad *quads,
+                                   unsigned int capacity)
+{
+    if(!f || !f->ptr)
+    {
+        fprintf(stderr, "FTGL warning: NULL pointer in %s\n", __FUNCTION__);
+        return 0;
+    }
+
+    FTQuadBuffer sink(quads, capacity);
+    f->ptr->Render(string, sink, -1, FTPoint(x, y));
+    return sink.Needed();
+}
+
+
+void ftglRenderFontToCallback(FTGLfont *f, const char *string, float x,
+                              float y, FTGLquadCallback callback, void *data)
+{
+    if(!f || !f->ptr)
+    {
+        fprintf(stderr, "FTGL warning: NULL pointer in %s\n", __FUNCTION__);
+        return;
+    }
+
+    FTQuadCallbackSink sink(callback, data);
+    f->ptr->Render(string, sink, -1, FTPoint(x, y));
+}
+
+FTGL_END_C_DECLS
@@ -27,6 +27,8 @@
 
 #include "FTSize.h"
 
+#include FT_SIZES_H
+
 
 FTSize::FTSize()
 :   ftFace(0),
@@ -44,24 +46,77 @@ FTSize::~FTSize()
 
 bool FTSize::CharSize(FT_Face* face, unsigned int pointSize, unsigned int xRes, unsigned int yRes)
 {
-    if(size != pointSize || xResolution != xRes || yResolution != yRes)
+    FT_Size newSize = ftSize;
+
+    if(!newSize)
     {
-        err = FT_Set_Char_Size(*face, 0L, pointSize * 64, xResolution, yResolution);
+        err = FT_New_Size(*face, &newSize);
+        if(err)
+        {
+            return false;
+        }
+    }
+
+    err = FT_Activate_Size(newSize);
 
-        if(!err)
+    if(!err && (!ftSize || size != pointSize || xResolution != xRes || yResolution != yRes))
+    {
+        err = FT_Set_Char_Size(*face, 0L, pointSize * 64, xRes, yRes);
+    }
+
+    if(err)
+    {
+        if(newSize != ftSize)
         {
-            ftFace = face;
-            size = pointSize;
-            xResolution = xRes;
-            yResolution = yRes;
-            ftSize = (*ftFace)->size;
+            FT_Done_Size(newSize);
         }
+        return false;
     }
 
+    ftFace = face;
+    ftSize = newSize;
+    size = pointSize;
+    xResolution = xRes;
+    yResolution = yRes;
+
+    return true;
+}
+
+
+bool FTSize::Activate()
+{
+    err = ftSize ? FT_Activate_Size(ftSize) : 0;
     return !err;
 }
 
 
+void FTSize::Release()
+{
+    if(ftSize)
+    {
+        FT_Done_Size(ftSize);
+    }
+
+    ftFace = 0;
+    ftSize = 0;
+    size = 0;
+    xResolution = 0;
+    yResolution = 0;
+}
+
+
+FT_Fixed FTSize::XScale() const
+{
+    return ftSize == 0 ? 0 : ftSize->metrics.x_scale;
+}
+
+
+FT_Fixed FTSize::YScale() const
+{
+    return ftSize == 0 ? 0 : ftSize->metrics.y_scale;
+}
+
+
 unsigned int FTSize::CharSize() const
 {
     return size;
@@ -56,6 +56,10 @@ class FTSize
         /**
          * Sets the char size for the current face.
          *
+         * The first call gives this object a Freetype size of its own and
+         * makes it the face's active size, so a face can keep several
+         * sizes and switch between them with Activate.
+         *
          * This doesn't guarantee that the size was set correctly. Clients
          * should check errors. If an error does occur the size object isn't modified.
          *
@@ -75,6 +79,35 @@ class FTSize
          */
         unsigned int CharSize() const;
 
+        /**
+         * get the resolution the char size was set for.
+         *
+         * @return The horizontal resolution in dots per inch
+         */
+        unsigned int Resolution() const { return xResolution; }
+
+        /**
+         * Make this the size glyphs are loaded at.
+         *
+         * @return  <code>true</code> if the size was activated.
+         */
+        bool Activate();
+
+        /**
+         * Free the Freetype size. Copies of this object must not be used
+         * afterwards.
+         */
+        void Release();
+
+        /**
+         * Gets the Freetype scale from font units to 26.6 pixels.
+         *
+         * @return  The horizontal or vertical scale, or 0 if no size is set.
+         */
+        FT_Fixed XScale() const;
+
+        FT_Fixed YScale() const;
+
         /**
          * Gets the global ascender height for the face in pixels.
          *
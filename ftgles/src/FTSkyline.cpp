@@ -0,0 +1,171 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#include "config.h"
+
+#include "FTSkyline.h"
+
+
+FTSkyline::FTSkyline()
+:   pageWidth(0),
+    pageHeight(0),
+    usedArea(0)
+{}
+
+
+void FTSkyline::Reset(int width, int height)
+{
+    Segment floor = { 0, 0, width };
+
+    pageWidth = width;
+    pageHeight = height;
+    usedArea = 0;
+    skyline.resize(0, floor);
+    skyline.push_back(floor);
+}
+
+
+int FTSkyline::Fit(unsigned int index, int width, int height) const
+{
+    int x = skyline[index].x;
+    int y = 0;
+
+    if(x + width > pageWidth)
+    {
+        return -1;
+    }
+
+    // Rest on the highest segment under the rectangle
+    for(int remaining = width; remaining > 0; ++index)
+    {
+        if(skyline[index].y > y)
+        {
+            y = skyline[index].y;
+        }
+
+        if(y + height > pageHeight)
+        {
+            return -1;
+        }
+
+        remaining -= skyline[index].width;
+    }
+
+    return y;
+}
+
+
+bool FTSkyline::Insert(int width, int height, int& x, int& y)
+{
+    unsigned int best = 0;
+    int bestTop = pageHeight + 1;
+    int bestWidth = 0;
+
+    if(width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    for(unsigned int i = 0; i < skyline.size(); ++i)
+    {
+        int fit = Fit(i, width, height);
+
+        // Lowest top edge first, then the narrowest segment
+        if(fit >= 0 && (fit + height < bestTop ||
+           (fit + height == bestTop && skyline[i].width < bestWidth)))
+        {
+            best = i;
+            bestTop = fit + height;
+            bestWidth = skyline[i].width;
+        }
+    }
+
+    if(bestTop > pageHeight)
+    {
+        return false;
+    }
+
+    x = skyline[best].x;
+    y = bestTop - height;
+
+    // Rebuild the skyline with the new segment in place of the ones it
+    // covers, merging neighbours of equal height. It is short, so copying
+    // is cheap.
+    Segment placed = { x, bestTop, width };
+    int right = x + width;
+
+    scratch.resize(0, placed);
+    for(unsigned int i = 0; i < skyline.size(); ++i)
+    {
+        Segment s = skyline[i];
+
+        if(i == best)
+        {
+            Append(placed);
+        }
+
+        if(i < best)
+        {
+            Append(s);
+        }
+        else if(s.x + s.width > right)
+        {
+            if(s.x < right)
+            {
+                s.width -= right - s.x;
+                s.x = right;
+            }
+            Append(s);
+        }
+    }
+    skyline = scratch;
+
+    usedArea += static_cast<long>(width) * height;
+    return true;
+}
+
+
+void FTSkyline::Append(const Segment& segment)
+{
+    if(scratch.size() && scratch[scratch.size() - 1].y == segment.y)
+    {
+        scratch[scratch.size() - 1].width += segment.width;
+    }
+    else
+    {
+        scratch.push_back(segment);
+    }
+}
+
+
+float FTSkyline::Occupancy() const
+{
+    if(!pageWidth || !pageHeight)
+    {
+        return 0.0f;
+    }
+
+    return static_cast<float>(usedArea)
+           / (static_cast<float>(pageWidth) * pageHeight);
+}
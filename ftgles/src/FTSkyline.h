@@ -0,0 +1,106 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __FTSkyline__
+#define __FTSkyline__
+
+#include "FTVector.h"
+
+
+/**
+ * FTSkyline packs rectangles into a fixed size page, keeping the top edge
+ * of the packed area as a list of horizontal segments. Each rectangle is
+ * placed where it leaves the lowest top edge.
+ */
+class FTSkyline
+{
+    public:
+        FTSkyline();
+
+        /**
+         * Empty the packer and set the page size.
+         *
+         * @param width  Page width.
+         * @param height  Page height.
+         */
+        void Reset(int width, int height);
+
+        /**
+         * Find room for a rectangle.
+         *
+         * @param width  Rectangle width.
+         * @param height  Rectangle height.
+         * @param x  Set to the left edge of the rectangle's position.
+         * @param y  Set to the top edge of the rectangle's position.
+         * @return  <code>false</code> if the page has no room left for it.
+         */
+        bool Insert(int width, int height, int& x, int& y);
+
+        /**
+         * @return  The area taken up by the inserted rectangles.
+         */
+        long UsedArea() const { return usedArea; }
+
+        /**
+         * @return  The fraction of the page taken up by the inserted
+         *          rectangles, from 0 to 1.
+         */
+        float Occupancy() const;
+
+    private:
+        struct Segment
+        {
+            int x, y, width;
+        };
+
+        /**
+         * The y the rectangle would sit at if placed on segment
+         * <code>index</code>, or -1 if it does not fit there.
+         */
+        int Fit(unsigned int index, int width, int height) const;
+
+        /**
+         * Add a segment to the end of the skyline being rebuilt.
+         */
+        void Append(const Segment& segment);
+
+        /**
+         * Page dimensions.
+         */
+        int pageWidth, pageHeight;
+
+        /**
+         * The skyline, left to right.
+         */
+        FTVector<Segment> skyline;
+
+        /**
+         * Where the skyline is rebuilt after an insert.
+         */
+        FTVector<Segment> scratch;
+
+        long usedArea;
+};
+
+#endif  //  __FTSkyline__
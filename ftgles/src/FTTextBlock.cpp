@@ -0,0 +1,278 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#include "config.h"
+
+#include <wchar.h>
+
+#include "FTInternals.h"
+#include "FTTextBlockImpl.h"
+#include "FTFont/FTFontImpl.h"
+
+
+//
+//  FTTextBlock
+//
+
+
+FTTextBlock::FTTextBlock(FTFont* font)
+{
+    impl = new FTTextBlockImpl(font);
+}
+
+
+FTTextBlock::FTTextBlock(FTFont* font, const char* text)
+{
+    impl = new FTTextBlockImpl(font);
+    SetText(text);
+}
+
+
+FTTextBlock::~FTTextBlock()
+{
+    delete impl;
+}
+
+
+void FTTextBlock::SetFont(FTFont* font)
+{
+    if(impl->font != font)
+    {
+        impl->font = font;
+        impl->dirty = true;
+    }
+}
+
+
+FTFont* FTTextBlock::GetFont() const
+{
+    return impl->font;
+}
+
+
+void FTTextBlock::SetText(const char* text)
+{
+    impl->SetText(text, text ? strlen(text) + 1 : 0, false);
+}
+
+
+void FTTextBlock::SetText(const wchar_t* text)
+{
+    impl->SetText(text, text ? (wcslen(text) + 1) * sizeof(wchar_t) : 0, true);
+}
+
+
+FTPoint FTTextBlock::Render(FTPoint position)
+{
+    return impl->Render(position);
+}
+
+
+FTPoint FTTextBlock::Advance()
+{
+    if(impl->Stale())
+    {
+        impl->Build();
+    }
+
+    return impl->advance;
+}
+
+
+//
+//  FTTextBlockImpl
+//
+
+
+FTTextBlockImpl::FTTextBlockImpl(FTFont* f)
+:   font(f),
+    text(0),
+    textBytes(0),
+    wide(false),
+    dirty(true),
+    generation(0)
+{
+    memset(&capture, 0, sizeof(capture));
+}
+
+
+FTTextBlockImpl::~FTTextBlockImpl()
+{
+    free(text);
+    ftglesFreeCapture(&capture);
+}
+
+
+void FTTextBlockImpl::SetText(const void* string, size_t bytes, bool isWide)
+{
+    // Only compare text of the same size, so as not to read past the
+    // shorter of the two
+    if(text && string && wide == isWide && textBytes == bytes
+        && memcmp(text, string, bytes) == 0)
+    {
+        return;
+    }
+
+    free(text);
+    text = NULL;
+    textBytes = 0;
+
+    if(string)
+    {
+        text = malloc(bytes);
+        memcpy(text, string, bytes);
+        textBytes = bytes;
+    }
+
+    wide = isWide;
+    dirty = true;
+}
+
+
+bool FTTextBlockImpl::Stale() const
+{
+    return dirty || (font && font->impl->generation != generation);
+}
+
+
+void FTTextBlockImpl::Build()
+{
+    capture.count = 0;
+    advance = FTPoint();
+    dirty = false;
+
+    // Fonts drawing lines or triangles would draw while the block is built
+    if(!font || !text || !font->impl->RendersQuads())
+    {
+        return;
+    }
+
+    ftglesBeginCapture(&capture);
+
+    if(wide)
+    {
+        advance = font->Render((const wchar_t*)text);
+    }
+    else
+    {
+        advance = font->Render((const char*)text);
+    }
+
+    ftglesEndCapture();
+
+    // Rendering may have created glyphs, so read the generation afterwards.
+    generation = font->impl->generation;
+}
+
+
+FTPoint FTTextBlockImpl::Render(FTPoint position)
+{
+    if(Stale())
+    {
+        Build();
+    }
+
+    if(capture.count == 0)
+    {
+        return position + advance;
+    }
+
+    GLfloat dx = position.Xf();
+    GLfloat dy = position.Yf();
+
+    if(ftglesInSession() || ftglesInCapture())
+    {
+        ftglesSubmitQuads(capture.vertices, capture.textures, capture.count,
+                          dx, dy);
+    }
+    else
+    {
+        ftglesTextState_t textState;
+
+        ftglesSaveTextState(&textState);
+        ftglesLoadCurrentColor();
+
+        ftglBegin(GL_QUADS);
+        ftglesSubmitQuads(capture.vertices, capture.textures, capture.count,
+                          dx, dy);
+        ftglEnd();
+
+        ftglesRestoreTextState(&textState);
+    }
+
+    return position + advance;
+}
+
+
+//
+//  C API
+//
+
+
+FTGL_BEGIN_C_DECLS
+
+FTGLtextblock *ftglCreateTextBlock(FTGLfont *font)
+{
+    FTGLtextblock *ftgl = (FTGLtextblock *)malloc(sizeof(FTGLtextblock));
+    ftgl->ptr = new FTTextBlock(font ? font->ptr : NULL);
+    return ftgl;
+}
+
+
+void ftglDestroyTextBlock(FTGLtextblock *b)
+{
+    if(!b || !b->ptr)
+    {
+        fprintf(stderr, "FTGL warning: NULL pointer in %s\n", __FUNCTION__);
+        return;
+    }
+    delete b->ptr;
+    free(b);
+}
+
+
+#define C_FUN(cname, cargs, cxxname, cxxarg) \
+    void cname cargs \
+    { \
+        if(!b || !b->ptr) \
+        { \
+            fprintf(stderr, "FTGL warning: NULL pointer in %s\n", #cname); \
+            return; \
+        } \
+        b->ptr->cxxname cxxarg; \
+    }
+
+// void FTTextBlock::SetFont(FTFont* font);
+C_FUN(ftglSetTextBlockFont, (FTGLtextblock *b, FTGLfont *font),
+      SetFont, (font ? font->ptr : NULL));
+
+// void FTTextBlock::SetText(const char* text);
+C_FUN(ftglSetTextBlockText, (FTGLtextblock *b, const char *text),
+      SetText, (text));
+
+// FTPoint FTTextBlock::Render(FTPoint position);
+C_FUN(ftglRenderTextBlock, (FTGLtextblock *b, float x, float y),
+      Render, (FTPoint(x, y)));
+
+FTGL_END_C_DECLS
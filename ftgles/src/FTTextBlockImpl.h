@@ -0,0 +1,78 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#ifndef __FTTextBlockImpl__
+#define __FTTextBlockImpl__
+
+#include "FTGL/ftgles.h"
+#include "FTGL/ftglesGlue.h"
+
+class FTTextBlockImpl
+{
+        friend class FTTextBlock;
+
+    protected:
+        FTTextBlockImpl(FTFont* font);
+
+        ~FTTextBlockImpl();
+
+        void SetText(const void* string, size_t bytes, bool isWide);
+
+        /**
+         * Whether the recorded quads no longer match the text or font.
+         */
+        bool Stale() const;
+
+        /**
+         * Lay the text out at the origin and record its quads.
+         */
+        void Build();
+
+        FTPoint Render(FTPoint position);
+
+    private:
+        FTFont* font;
+
+        /**
+         * A copy of the text, nul terminated, and its size in bytes.
+         */
+        void* text;
+        size_t textBytes;
+        bool wide;
+
+        /**
+         * Set when the text or font changes.
+         */
+        bool dirty;
+
+        /**
+         * The font generation the quads were recorded at.
+         */
+        unsigned int generation;
+
+        ftglesCapture_t capture;
+        FTPoint advance;
+};
+
+#endif  //  __FTTextBlockImpl__
@@ -0,0 +1,142 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+#include "config.h"
+
+#include "FTInternals.h"
+
+
+//
+//  FTTextSession
+//
+
+
+FTTextSession::FTTextSession(ftglesContext* c)
+:   active(false),
+    context(c),
+    previous(0)
+{}
+
+
+FTTextSession::~FTTextSession()
+{
+    if(active)
+    {
+        End();
+    }
+}
+
+
+void FTTextSession::Begin()
+{
+    if(active)
+    {
+        return;
+    }
+
+    active = true;
+
+    if(context)
+    {
+        previous = ftglesGetCurrentContext();
+        ftglesMakeCurrent(context);
+    }
+
+    ftglesBeginSession();
+}
+
+
+void FTTextSession::End()
+{
+    if(!active)
+    {
+        return;
+    }
+
+    ftglesEndSession();
+    active = false;
+
+    if(context)
+    {
+        ftglesMakeCurrent(previous);
+    }
+}
+
+
+void FTTextSession::Color(float r, float g, float b, float a)
+{
+    ftglColor4f(r, g, b, a);
+}
+
+
+//
+//  C API
+//
+
+
+FTGL_BEGIN_C_DECLS
+
+FTGLsession *ftglCreateTextSession(void)
+{
+    FTGLsession *ftgl = (FTGLsession *)malloc(sizeof(FTGLsession));
+    ftgl->ptr = new FTTextSession();
+    return ftgl;
+}
+
+
+void ftglDestroyTextSession(FTGLsession *s)
+{
+    if(!s || !s->ptr)
+    {
+        fprintf(stderr, "FTGL warning: NULL pointer in %s\n", __FUNCTION__);
+        return;
+    }
+    delete s->ptr;
+    free(s);
+}
+
+
+#define C_FUN(cname, cargs, cxxname, cxxarg) \
+    void cname cargs \
+    { \
+        if(!s || !s->ptr) \
+        { \
+            fprintf(stderr, "FTGL warning: NULL pointer in %s\n", #cname); \
+            return; \
+        } \
+        s->ptr->cxxname cxxarg; \
+    }
+
+// void FTTextSession::Begin();
+C_FUN(ftglBeginTextSession, (FTGLsession *s), Begin, ());
+
+// void FTTextSession::End();
+C_FUN(ftglEndTextSession, (FTGLsession *s), End, ());
+
+// void FTTextSession::Color(float r, float g, float b, float a);
+C_FUN(ftglSetTextSessionColor,
+      (FTGLsession *s, float r, float g, float b, float a),
+      Color, (r, g, b, a));
+
+FTGL_END_C_DECLS
@@ -0,0 +1,169 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+
+#include "Fontdefs.h"
+#include "FTGL/ftgles.h"
+#include "FTInternals.h"
+
+
+class FTAtlasManagerTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTAtlasManagerTest);
+        CPPUNIT_TEST(testSharedGlyphs);
+        CPPUNIT_TEST(testSession);
+        CPPUNIT_TEST(testBudget);
+        CPPUNIT_TEST(testDetach);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTAtlasManagerTest() : CppUnit::TestCase("FTAtlasManager Test")
+        {}
+
+        FTAtlasManagerTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testSharedGlyphs()
+        {
+            FTAtlasManager* manager = new FTAtlasManager;
+            manager->PageSize(256);
+
+            FTTextureFont* first = new FTTextureFont(FONT_FILE);
+            FTTextureFont* second = new FTTextureFont(FONT_FILE);
+            first->AtlasManager(manager);
+            second->AtlasManager(manager);
+            first->FaceSize(24);
+            second->FaceSize(24);
+
+            first->Render(GOOD_ASCII_TEST_STRING);
+            unsigned int uploads = recording.uploads;
+            CPPUNIT_ASSERT_EQUAL(1u, recording.textures);
+
+            // The same face and size finds the bitmaps already uploaded.
+            second->Render(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT_EQUAL(uploads, recording.uploads);
+            CPPUNIT_ASSERT_EQUAL(1u, manager->PageCount());
+
+            // Another size needs bitmaps of its own, on the same page.
+            second->FaceSize(30);
+            second->Render(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT(recording.uploads > uploads);
+            CPPUNIT_ASSERT_EQUAL(1u, recording.textures);
+
+            // Fonts keep the pages alive.
+            delete manager;
+            first->Render(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT(first->Error() == 0);
+
+            delete first;
+            delete second;
+        }
+
+        void testSession()
+        {
+            FTAtlasManager* manager = new FTAtlasManager;
+            manager->PageSize(512);
+
+            FTTextureFont* small = new FTTextureFont(FONT_FILE);
+            FTTextureFont* large = new FTTextureFont(FONT_FILE);
+            small->AtlasManager(manager);
+            large->AtlasManager(manager);
+            small->FaceSize(12);
+            large->FaceSize(36);
+
+            // Make the glyphs before counting draws.
+            small->Render(GOOD_ASCII_TEST_STRING);
+            large->Render(GOOD_ASCII_TEST_STRING);
+            recording.draws = 0;
+
+            ftglesBeginSession();
+            small->Render(GOOD_ASCII_TEST_STRING);
+            large->Render(GOOD_ASCII_TEST_STRING);
+            small->Render(GOOD_ASCII_TEST_STRING);
+            ftglesEndSession();
+
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+
+            delete small;
+            delete large;
+            delete manager;
+        }
+
+        void testBudget()
+        {
+            FTAtlasManager* manager = new FTAtlasManager;
+            manager->PageSize(64);
+            manager->PageBudget(1);
+
+            FTTextureFont* first = new FTTextureFont(FONT_FILE);
+            FTTextureFont* second = new FTTextureFont(FONT_FILE);
+            first->AtlasManager(manager);
+            second->AtlasManager(manager);
+            first->FaceSize(24);
+            second->FaceSize(20);
+
+            const char* alphabet = "abcdefghijklmnopqrstuvwxyz";
+            first->Render(alphabet);
+            second->Render(alphabet);
+            first->Render(alphabet);
+
+            // Eviction unloads glyphs from both fonts, which remake them.
+            CPPUNIT_ASSERT_EQUAL(1u, manager->PageCount());
+            CPPUNIT_ASSERT_EQUAL(1u, recording.textures);
+
+            float advance = second->Advance(alphabet);
+            FTPoint pen = second->Render(alphabet);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(advance, pen.Xf(), 0.01);
+
+            delete first;
+            delete second;
+            delete manager;
+        }
+
+        void testDetach()
+        {
+            FTAtlasManager* manager = new FTAtlasManager;
+
+            FTTextureFont* font = new FTTextureFont(FONT_FILE);
+            font->FaceSize(24);
+            font->Render(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT_EQUAL(1u, font->PageCount());
+
+            font->AtlasManager(manager);
+            CPPUNIT_ASSERT_EQUAL(0u, font->PageCount());
+            font->Render(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT_EQUAL(1u, manager->PageCount());
+
+            font->AtlasManager(NULL);
+            CPPUNIT_ASSERT_EQUAL(0u, font->PageCount());
+            font->Render(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT_EQUAL(1u, font->PageCount());
+            CPPUNIT_ASSERT_EQUAL(1u, manager->PageCount());
+
+            delete manager;
+            delete font;
+        }
+
+        void setUp()
+        {
+            context = ftglesCreateContext(0);
+            ftglesMakeCurrent(context);
+            ftglesInitRecordingBackend(&backend, &recording);
+            ftglesSetBackend(&backend);
+        }
+
+        void tearDown()
+        {
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
+        }
+
+    private:
+        ftglesContext* context;
+        ftglesBackend_t backend;
+        ftglesRecording_t recording;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTAtlasManagerTest);
+
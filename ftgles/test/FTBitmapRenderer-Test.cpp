@@ -0,0 +1,209 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+#include <pthread.h>
+#include <string.h>
+
+#include "Fontdefs.h"
+
+#include "FTGL/ftgles.h"
+#include "FTInternals.h"
+
+static const int WIDTH = 128;
+static const int HEIGHT = 48;
+static const int STRIDE = 136;
+
+static void RenderHello(unsigned char* pixels)
+{
+    FTBitmapRenderer renderer(FONT_FILE);
+    renderer.Font()->FaceSize(18);
+    renderer.Target(pixels, WIDTH, HEIGHT, STRIDE);
+    renderer.Render("Hello", -1, FTPoint(4, 12));
+}
+
+static void* RenderThread(void* data)
+{
+    unsigned char* pixels = static_cast<unsigned char*>(data);
+
+    for(int i = 0; i < 20; ++i)
+    {
+        memset(pixels, 0, STRIDE * HEIGHT);
+        RenderHello(pixels);
+    }
+
+    return NULL;
+}
+
+class FTBitmapRendererTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTBitmapRendererTest);
+        CPPUNIT_TEST(testConstructor);
+        CPPUNIT_TEST(testRender);
+        CPPUNIT_TEST(testColor);
+        CPPUNIT_TEST(testLayout);
+        CPPUNIT_TEST(testThreads);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTBitmapRendererTest() : CppUnit::TestCase("FTBitmapRenderer Test")
+        {
+        }
+
+        FTBitmapRendererTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testConstructor()
+        {
+            FTBitmapRenderer* bad = new FTBitmapRenderer(BAD_FONT_FILE);
+            CPPUNIT_ASSERT(bad->Error() != 0);
+            delete bad;
+
+            FTBitmapRenderer* good = new FTBitmapRenderer(FONT_FILE);
+            CPPUNIT_ASSERT_EQUAL(0, (int)good->Error());
+            delete good;
+        }
+
+        void testRender()
+        {
+            unsigned char pixels[STRIDE * HEIGHT];
+            memset(pixels, 0x55, sizeof(pixels));
+            for(int y = 0; y < HEIGHT; ++y)
+            {
+                memset(pixels + y * STRIDE, 0, WIDTH);
+            }
+
+            FTBitmapRenderer renderer(FONT_FILE);
+            renderer.Font()->FaceSize(18);
+            renderer.Target(pixels, WIDTH, HEIGHT, STRIDE);
+            FTPoint end = renderer.Render("Hello", -1, FTPoint(4, 12));
+
+            // The same advance as a buffer font
+            FTBufferFont bufferFont(FONT_FILE);
+            bufferFont.FaceSize(18);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(4 + bufferFont.Advance("Hello"),
+                                         end.X(), 0.01);
+
+            // Ink above the baseline, none left of the pen, and nothing
+            // written past the target's width
+            int inked = 0;
+            for(int y = 0; y < HEIGHT; ++y)
+            {
+                for(int x = 0; x < STRIDE; ++x)
+                {
+                    unsigned char p = pixels[y * STRIDE + x];
+
+                    if(x >= WIDTH)
+                    {
+                        CPPUNIT_ASSERT_EQUAL(0x55, (int)p);
+                    }
+                    else if(p)
+                    {
+                        CPPUNIT_ASSERT(x >= 4);
+                        CPPUNIT_ASSERT(y <= HEIGHT - 12);
+                        inked++;
+                    }
+                }
+            }
+            CPPUNIT_ASSERT(inked > 50);
+
+            // Text off the target draws nothing but still advances
+            unsigned char before[STRIDE * HEIGHT];
+            memcpy(before, pixels, sizeof(pixels));
+            end = renderer.Render("Hello", -1, FTPoint(-500, 12));
+            CPPUNIT_ASSERT(end.X() > -500);
+            CPPUNIT_ASSERT(!memcmp(before, pixels, sizeof(pixels)));
+        }
+
+        void testColor()
+        {
+            unsigned char coverage[STRIDE * HEIGHT];
+            memset(coverage, 0, sizeof(coverage));
+            RenderHello(coverage);
+
+            unsigned char rgba[WIDTH * 4 * HEIGHT];
+            memset(rgba, 0, sizeof(rgba));
+
+            FTBitmapRenderer renderer(FONT_FILE);
+            renderer.Font()->FaceSize(18);
+            renderer.Target(rgba, WIDTH, HEIGHT, WIDTH * 4, FTGL::PIXEL_RGBA8);
+            renderer.Color(255, 0, 0);
+            renderer.Render("Hello", -1, FTPoint(4, 12));
+
+            // Over transparent black: the colour, with coverage as alpha
+            for(int y = 0; y < HEIGHT; ++y)
+            {
+                for(int x = 0; x < WIDTH; ++x)
+                {
+                    const unsigned char* p = rgba + (y * WIDTH + x) * 4;
+                    unsigned char a = coverage[y * STRIDE + x];
+
+                    CPPUNIT_ASSERT_EQUAL((int)a, (int)p[3]);
+                    CPPUNIT_ASSERT_EQUAL(a ? 255 : 0, (int)p[0]);
+                    CPPUNIT_ASSERT_EQUAL(0, (int)p[1]);
+                }
+            }
+        }
+
+        void testLayout()
+        {
+            unsigned char pixels[STRIDE * HEIGHT * 2];
+            memset(pixels, 0, sizeof(pixels));
+
+            FTBitmapRenderer renderer(FONT_FILE);
+            renderer.Font()->FaceSize(14);
+            renderer.Target(pixels, WIDTH, HEIGHT * 2, STRIDE);
+
+            FTSimpleLayout layout;
+            layout.SetFont(renderer.Font());
+            layout.SetLineLength(WIDTH - 8);
+            renderer.Render(layout, "The quick brown fox jumps over the "
+                            "lazy dog", -1, FTPoint(4, HEIGHT * 2 - 16));
+
+            // Wrapped onto more than one line
+            int top = -1, bottom = -1;
+            for(int y = 0; y < HEIGHT * 2; ++y)
+            {
+                for(int x = 0; x < WIDTH; ++x)
+                {
+                    if(pixels[y * STRIDE + x])
+                    {
+                        top = top < 0 ? y : top;
+                        bottom = y;
+                    }
+                }
+            }
+            CPPUNIT_ASSERT(top >= 0);
+            CPPUNIT_ASSERT(bottom - top > renderer.Font()->LineHeight());
+        }
+
+        void testThreads()
+        {
+            unsigned char expected[STRIDE * HEIGHT];
+            memset(expected, 0, sizeof(expected));
+            RenderHello(expected);
+
+            const int count = 4;
+            pthread_t threads[count];
+            unsigned char pixels[count][STRIDE * HEIGHT];
+
+            for(int i = 0; i < count; ++i)
+            {
+                pthread_create(&threads[i], NULL, RenderThread, pixels[i]);
+            }
+
+            for(int i = 0; i < count; ++i)
+            {
+                pthread_join(threads[i], NULL);
+                CPPUNIT_ASSERT(!memcmp(expected, pixels[i], sizeof(expected)));
+            }
+        }
+
+        void setUp()
+        {}
+
+        void tearDown()
+        {}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTBitmapRendererTest);
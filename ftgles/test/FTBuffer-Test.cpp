@@ -0,0 +1,131 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <string.h>
+
+#include "FTGL/ftgles.h"
+
+class FTBufferTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTBufferTest);
+        CPPUNIT_TEST(testConstructor);
+        CPPUNIT_TEST(testSize);
+        CPPUNIT_TEST(testDirty);
+        CPPUNIT_TEST(testCapacity);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTBufferTest() : CppUnit::TestCase("FTBuffer Test")
+        {
+        }
+
+        FTBufferTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testConstructor()
+        {
+            FTBuffer buffer;
+
+            CPPUNIT_ASSERT_EQUAL(0, buffer.Width());
+            CPPUNIT_ASSERT_EQUAL(0, buffer.Height());
+        }
+
+        void testSize()
+        {
+            FTBuffer buffer;
+            buffer.Size(16, 8);
+
+            CPPUNIT_ASSERT_EQUAL(16, buffer.Width());
+            CPPUNIT_ASSERT_EQUAL(8, buffer.Height());
+            CPPUNIT_ASSERT(Cleared(buffer));
+
+            // Resizing to the same size still clears
+            Fill(buffer, 2, 2, 4, 4);
+            buffer.Size(16, 8);
+            CPPUNIT_ASSERT(Cleared(buffer));
+        }
+
+        void testDirty()
+        {
+            FTBuffer buffer;
+
+            // Regions written at one width are cleared at another
+            buffer.Size(20, 10);
+            Fill(buffer, 3, 1, 5, 2);
+            Fill(buffer, 12, 6, 8, 4);
+            buffer.Size(10, 20);
+            CPPUNIT_ASSERT(Cleared(buffer));
+
+            // Whole rows
+            Fill(buffer, 0, 4, 10, 6);
+            buffer.Size(5, 40);
+            CPPUNIT_ASSERT(Cleared(buffer));
+
+            // Regions are clipped to the buffer
+            Fill(buffer, -3, -3, 6, 6);
+            Fill(buffer, 2, 36, 10, 10);
+            buffer.Dirty(-10, 50, 4, 4);
+            buffer.Size(40, 5);
+            CPPUNIT_ASSERT(Cleared(buffer));
+        }
+
+        void testCapacity()
+        {
+            FTBuffer buffer;
+            buffer.Size(32, 32);
+            unsigned char* pixels = buffer.Pixels();
+
+            // Smaller sizes reuse the memory
+            buffer.Size(8, 8);
+            CPPUNIT_ASSERT(pixels == buffer.Pixels());
+            buffer.Size(0, 0);
+            CPPUNIT_ASSERT(pixels == buffer.Pixels());
+            buffer.Size(16, 64);
+            CPPUNIT_ASSERT(pixels == buffer.Pixels());
+            CPPUNIT_ASSERT(Cleared(buffer));
+
+            // Larger ones start cleared
+            Fill(buffer, 0, 0, 16, 64);
+            buffer.Size(64, 64);
+            CPPUNIT_ASSERT(Cleared(buffer));
+        }
+
+        void setUp()
+        {}
+
+        void tearDown()
+        {}
+
+    private:
+        void Fill(FTBuffer& buffer, int x, int y, int w, int h)
+        {
+            for(int j = y; j < y + h; ++j)
+            {
+                for(int i = x; i < x + w; ++i)
+                {
+                    if(i >= 0 && i < buffer.Width()
+                        && j >= 0 && j < buffer.Height())
+                    {
+                        buffer.Pixels()[j * buffer.Width() + i] = 0xff;
+                    }
+                }
+            }
+
+            buffer.Dirty(x, y, w, h);
+        }
+
+        bool Cleared(const FTBuffer& buffer)
+        {
+            for(int i = 0; i < buffer.Width() * buffer.Height(); ++i)
+            {
+                if(buffer.Pixels()[i])
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTBufferTest);
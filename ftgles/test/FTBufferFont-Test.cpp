@@ -0,0 +1,124 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+#include <stdio.h>
+
+#include "Fontdefs.h"
+
+#include "FTGL/ftgles.h"
+#include "FTInternals.h"
+
+class FTBufferFontTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTBufferFontTest);
+        CPPUNIT_TEST(testCache);
+        CPPUNIT_TEST(testPages);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTBufferFontTest() : CppUnit::TestCase("FTBufferFont Test")
+        {
+        }
+
+        FTBufferFontTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testCache()
+        {
+            FTBufferFont* bufferFont = new FTBufferFont(FONT_FILE);
+            bufferFont->FaceSize(18);
+            bufferFont->CacheSize(2);
+
+            // The page, then the string.
+            bufferFont->Render("one");
+            bufferFont->Render("one");
+            CPPUNIT_ASSERT_EQUAL(2u, recording.uploads);
+
+            // "one" was rendered least recently, so makes way for "three".
+            bufferFont->Render("two");
+            bufferFont->Render("three");
+            bufferFont->Render("two");
+            CPPUNIT_ASSERT_EQUAL(4u, recording.uploads);
+            bufferFont->Render("one");
+            CPPUNIT_ASSERT_EQUAL(5u, recording.uploads);
+            bufferFont->Render("two");
+            bufferFont->Render("one two", 3);
+            CPPUNIT_ASSERT_EQUAL(5u, recording.uploads);
+
+            // Spacing is part of the key.
+            bufferFont->Render("one", -1, FTPoint(), FTPoint(2.0f, 0.0f));
+            CPPUNIT_ASSERT_EQUAL(6u, recording.uploads);
+
+            // A byte limit below one string keeps only the latest.
+            bufferFont->CacheSize(0, 1);
+            bufferFont->Render("two");
+            bufferFont->Render("two");
+            CPPUNIT_ASSERT_EQUAL(7u, recording.uploads);
+            bufferFont->Render(L"one");
+            bufferFont->Render("two");
+            CPPUNIT_ASSERT_EQUAL(9u, recording.uploads);
+
+            delete bufferFont;
+        }
+
+        void testPages()
+        {
+            FTBufferFont* bufferFont = new FTBufferFont(FONT_FILE);
+            bufferFont->FaceSize(18);
+            char label[32];
+
+            // The labels share one page, drawn in one batch.
+            ftglesBeginSession();
+            for(int i = 0; i < 10; ++i)
+            {
+                sprintf(label, "Label %d", i);
+                bufferFont->Render(label, -1, FTPoint(0.0f, i * 20.0f));
+            }
+            ftglesEndSession();
+            CPPUNIT_ASSERT_EQUAL(1u, recording.textures);
+            CPPUNIT_ASSERT_EQUAL(11u, recording.uploads);
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+
+            // Only the string's own pixels are uploaded.
+            unsigned long bytes = recording.uploadBytes;
+            bufferFont->Render("A label much longer than the others");
+            CPPUNIT_ASSERT(recording.uploadBytes > bytes);
+            CPPUNIT_ASSERT(recording.uploadBytes - bytes < 512 * 32);
+
+            // A one page budget recycles the page.
+            bufferFont->CacheSize(0, 512 * 512);
+            for(int i = 0; i < 200; ++i)
+            {
+                sprintf(label, "Another label %d", i);
+                bufferFont->Render(label);
+            }
+            CPPUNIT_ASSERT_EQUAL(1u, recording.textures);
+            unsigned int uploads = recording.uploads;
+            bufferFont->Render("Another label 0");
+            CPPUNIT_ASSERT_EQUAL(uploads + 1, recording.uploads);
+
+            delete bufferFont;
+        }
+
+        void setUp()
+        {
+            context = ftglesCreateContext(0);
+            ftglesMakeCurrent(context);
+            ftglesInitRecordingBackend(&backend, &recording);
+            ftglesSetBackend(&backend);
+        }
+
+        void tearDown()
+        {
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
+        }
+
+    private:
+        ftglesContext* context;
+        ftglesBackend_t backend;
+        ftglesRecording_t recording;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTBufferFontTest);
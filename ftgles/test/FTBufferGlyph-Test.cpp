@@ -0,0 +1,136 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+
+#include "Fontdefs.h"
+
+#include "FTGL/ftgles.h"
+#include "FTInternals.h"
+
+class FTBufferGlyphTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTBufferGlyphTest);
+        CPPUNIT_TEST(testOverlap);
+        CPPUNIT_TEST(testClipping);
+        CPPUNIT_TEST(testDirty);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTBufferGlyphTest() : CppUnit::TestCase("FTBufferGlyph Test")
+        {
+        }
+
+        FTBufferGlyphTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testOverlap()
+        {
+            FTBuffer first, second, both;
+            first.Size(64, 64);
+            second.Size(64, 64);
+            both.Size(64, 64);
+
+            Render(first, FTPoint(10, 20));
+            Render(second, FTPoint(14, 20));
+            Render(both, FTPoint(10, 20));
+            Render(both, FTPoint(14, 20));
+
+            // Overlapping glyphs keep the higher coverage
+            for(int i = 0; i < 64 * 64; ++i)
+            {
+                unsigned char a = first.Pixels()[i];
+                unsigned char b = second.Pixels()[i];
+                CPPUNIT_ASSERT_EQUAL(a > b ? a : b, both.Pixels()[i]);
+            }
+        }
+
+        void testClipping()
+        {
+            FTBuffer small, large;
+            small.Size(16, 16);
+            large.Size(56, 56);
+            large.Pos(FTPoint(20, 20));
+
+            const FTPoint pens[] =
+            {
+                FTPoint(-8, -4), FTPoint(10, -6), FTPoint(-6, 10),
+                FTPoint(12, 12), FTPoint(4, 4)
+            };
+
+            for(unsigned int i = 0; i < sizeof(pens) / sizeof(pens[0]); ++i)
+            {
+                Render(small, pens[i]);
+                Render(large, pens[i]);
+            }
+
+            // The small buffer holds what fits of the same glyphs
+            for(int y = 0; y < 16; ++y)
+            {
+                for(int x = 0; x < 16; ++x)
+                {
+                    CPPUNIT_ASSERT_EQUAL(large.Pixels()[(y + 20) * 56 + x + 20],
+                                         small.Pixels()[y * 16 + x]);
+                }
+            }
+
+            // Nothing lands entirely outside
+            small.Size(0, 0);
+            small.Size(16, 16);
+            Render(small, FTPoint(-100, 4));
+            Render(small, FTPoint(4, 100));
+            for(int i = 0; i < 16 * 16; ++i)
+            {
+                CPPUNIT_ASSERT_EQUAL(0, (int)small.Pixels()[i]);
+            }
+        }
+
+        void testDirty()
+        {
+            FTBuffer buffer;
+            buffer.Size(48, 24);
+
+            Render(buffer, FTPoint(-4, 6));
+            Render(buffer, FTPoint(20, 12));
+            Render(buffer, FTPoint(40, -2));
+
+            // Glyphs mark what they draw, so a resize clears all of it
+            buffer.Size(24, 48);
+            for(int i = 0; i < 24 * 48; ++i)
+            {
+                CPPUNIT_ASSERT_EQUAL(0, (int)buffer.Pixels()[i]);
+            }
+        }
+
+        void setUp()
+        {
+            FT_Error error = FT_Init_FreeType(&library);
+            assert(!error);
+            error = FT_New_Face(library, FONT_FILE, 0, &face);
+            assert(!error);
+
+            FT_Set_Char_Size(face, 0L, FONT_POINT_SIZE * 64, RESOLUTION, RESOLUTION);
+        }
+
+        void tearDown()
+        {
+            FT_Done_Face(face);
+            FT_Done_FreeType(library);
+        }
+
+    private:
+        FT_Library   library;
+        FT_Face      face;
+
+        void Render(FTBuffer& buffer, const FTPoint& pen)
+        {
+            FT_Error error = FT_Load_Char(face, 'o', FT_LOAD_DEFAULT);
+            assert(!error);
+
+            FTBufferGlyph glyph(face->glyph, &buffer);
+            CPPUNIT_ASSERT(glyph.Error() == 0);
+            glyph.Render(pen, FTGL::RENDER_FRONT);
+        }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTBufferGlyphTest);
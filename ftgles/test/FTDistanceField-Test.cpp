@@ -0,0 +1,153 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+
+#include "Fontdefs.h"
+#include "FTGL/ftgles.h"
+#include "FTInternals.h"
+#include "FTDistanceField.h"
+
+
+class FTDistanceFieldTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTDistanceFieldTest);
+        CPPUNIT_TEST(testSquare);
+        CPPUNIT_TEST(testPitch);
+        CPPUNIT_TEST(testEmpty);
+        CPPUNIT_TEST(testTextureFont);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTDistanceFieldTest() : CppUnit::TestCase("FTDistanceField Test")
+        {}
+
+        FTDistanceFieldTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testSquare()
+        {
+            // An 8x8 square in the middle of a 12x12 bitmap.
+            unsigned char coverage[12 * 12];
+            for(int y = 0; y < 12; ++y)
+            {
+                for(int x = 0; x < 12; ++x)
+                {
+                    bool in = x >= 2 && x < 10 && y >= 2 && y < 10;
+                    coverage[y * 12 + x] = in ? 255 : 0;
+                }
+            }
+
+            FTDistanceField field;
+            CPPUNIT_ASSERT_EQUAL(20, FTDistanceField::FieldSize(12, 4));
+
+            unsigned char out[20 * 20];
+            field.Generate(coverage, 12, 12, 12, 4, out);
+
+            // Bitmap (2, 6) is field (6, 10): just inside the left edge.
+            CPPUNIT_ASSERT_EQUAL(144, (int)out[10 * 20 + 6]);
+            CPPUNIT_ASSERT_EQUAL(112, (int)out[10 * 20 + 5]);
+
+            // The centre is three and a half texels in; far outside
+            // saturates.
+            CPPUNIT_ASSERT_EQUAL(240, (int)out[10 * 20 + 10]);
+            CPPUNIT_ASSERT_EQUAL(0, (int)out[0]);
+
+            // Distances fall off evenly outside.
+            CPPUNIT_ASSERT(out[10 * 20 + 4] < out[10 * 20 + 5]);
+            CPPUNIT_ASSERT_EQUAL((int)out[10 * 20 + 5], (int)out[5 * 20 + 10]);
+            CPPUNIT_ASSERT_EQUAL((int)out[10 * 20 + 5], (int)out[10 * 20 + 14]);
+        }
+
+        void testPitch()
+        {
+            // The top row set, stored bottom up with padded rows.
+            unsigned char coverage[4 * 8];
+            memset(coverage, 0, sizeof(coverage));
+            memset(coverage + 3 * 8, 255, 4);
+
+            FTDistanceField field;
+            unsigned char out[8 * 8];
+            field.Generate(coverage, 4, 4, -8, 2, out);
+
+            CPPUNIT_ASSERT(out[2 * 8 + 3] > 128);
+            CPPUNIT_ASSERT(out[5 * 8 + 3] < 128);
+        }
+
+        void testEmpty()
+        {
+            unsigned char coverage[4 * 4];
+            memset(coverage, 100, sizeof(coverage));
+
+            FTDistanceField field;
+            unsigned char out[8 * 8];
+            field.Generate(coverage, 4, 4, 4, 2, out);
+
+            for(int i = 0; i < 8 * 8; ++i)
+            {
+                CPPUNIT_ASSERT_EQUAL(0, (int)out[i]);
+            }
+        }
+
+        void testTextureFont()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->FaceSize(24);
+            float advance = textureFont->Advance(GOOD_ASCII_TEST_STRING);
+            float ascender = textureFont->Ascender();
+
+            textureFont->DistanceField(48);
+            textureFont->FaceSize(24);
+            CPPUNIT_ASSERT_EQUAL(24u, textureFont->FaceSize());
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(advance,
+                textureFont->Advance(GOOD_ASCII_TEST_STRING), advance * 0.05);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(ascender, textureFont->Ascender(),
+                                         ascender * 0.05);
+
+            textureFont->Render(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5f, recording.alphaTest, 0.001);
+            unsigned int uploads = recording.uploads;
+
+            // Every size draws from the same fields.
+            for(unsigned int size = 10; size < 100; size += 7)
+            {
+                textureFont->FaceSize(size);
+                FTPoint pen = textureFont->Render(GOOD_ASCII_TEST_STRING);
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(textureFont->Advance(GOOD_ASCII_TEST_STRING),
+                                             pen.Xf(), 0.01);
+            }
+            CPPUNIT_ASSERT_EQUAL(uploads, recording.uploads);
+
+            // Twice the size, twice the box.
+            textureFont->FaceSize(20);
+            FTBBox small = textureFont->BBox(GOOD_ASCII_TEST_STRING);
+            textureFont->FaceSize(40);
+            FTBBox large = textureFont->BBox(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(small.Upper().Xf() * 2,
+                                         large.Upper().Xf(), 0.01);
+
+            delete textureFont;
+        }
+
+        void setUp()
+        {
+            context = ftglesCreateContext(0);
+            ftglesMakeCurrent(context);
+            ftglesInitRecordingBackend(&backend, &recording);
+            ftglesSetBackend(&backend);
+        }
+
+        void tearDown()
+        {
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
+        }
+
+    private:
+        ftglesContext* context;
+        ftglesBackend_t backend;
+        ftglesRecording_t recording;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTDistanceFieldTest);
+
@@ -84,6 +84,8 @@ class FTFontTest : public CppUnit::TestCase
         CPPUNIT_TEST(testCheckGlyphFailure);
         CPPUNIT_TEST(testAdvance);
         CPPUNIT_TEST(testRender);
+        CPPUNIT_TEST(testPreload);
+        CPPUNIT_TEST(testCachedSizes);
     CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -259,21 +261,88 @@ class FTFontTest : public CppUnit::TestCase
             CPPUNIT_ASSERT_EQUAL(testFont->Error(), 0);
         }
 
+        void testPreload()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->FaceSize(18);
+
+            CPPUNIT_ASSERT_EQUAL(8u, textureFont->Preload(GOOD_ASCII_TEST_STRING));
+            CPPUNIT_ASSERT_EQUAL(0u, textureFont->Preload(GOOD_ASCII_TEST_STRING));
+            CPPUNIT_ASSERT_EQUAL(95u - 8u, textureFont->Preload(' ', '~'));
+
+            // Unmapped characters are skipped.
+            CPPUNIT_ASSERT_EQUAL(0u, textureFont->Preload(0xe000, 0xe0ff));
+
+            // Empty ranges, and ranges running to the last code, end.
+            CPPUNIT_ASSERT_EQUAL(0u, textureFont->Preload('~', ' '));
+            CPPUNIT_ASSERT_EQUAL(0u, textureFont->Preload(0xffffff00u,
+                                                          0xffffffffu));
+
+            // Rendering finds every glyph already uploaded.
+            unsigned int uploads = recording.uploads;
+            textureFont->Render("The quick brown fox, 0123456789!");
+            CPPUNIT_ASSERT_EQUAL(uploads, recording.uploads);
+
+            delete textureFont;
+        }
+
+        void testCachedSizes()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->FaceSize(18);
+            float ascender = textureFont->Ascender();
+            CPPUNIT_ASSERT_EQUAL(4u, textureFont->Preload("Hello"));
+            textureFont->FaceSize(36);
+            CPPUNIT_ASSERT_EQUAL(4u, textureFont->Preload("Hello"));
+
+            // Switching back makes nothing again.
+            unsigned int uploads = recording.uploads;
+            textureFont->FaceSize(18);
+            CPPUNIT_ASSERT_EQUAL(0u, textureFont->Preload("Hello"));
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(ascender, textureFont->Ascender(), 0.01);
+            textureFont->FaceSize(36);
+            CPPUNIT_ASSERT_EQUAL(0u, textureFont->Preload("Hello"));
+            CPPUNIT_ASSERT_EQUAL(18u, textureFont->FaceSize() / 2);
+            textureFont->Render("Hello");
+            CPPUNIT_ASSERT_EQUAL(uploads, recording.uploads);
+
+            // Only the current size is kept.
+            textureFont->CachedSizes(1);
+            textureFont->FaceSize(18);
+            CPPUNIT_ASSERT_EQUAL(4u, textureFont->Preload("Hello"));
+            textureFont->FaceSize(36);
+            CPPUNIT_ASSERT_EQUAL(4u, textureFont->Preload("Hello"));
+
+            delete textureFont;
+        }
+
 
         void setUp()
         {
             testFont = new TestFont(GOOD_FONT_FILE);
+
+            context = ftglesCreateContext(0);
+            ftglesMakeCurrent(context);
+            ftglesInitRecordingBackend(&backend, &recording);
+            ftglesSetBackend(&backend);
         }
 
 
         void tearDown()
         {
             delete testFont;
+
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
         }
 
     private:
         TestFont* testFont;
 
+        ftglesContext* context;
+        ftglesBackend_t backend;
+        ftglesRecording_t recording;
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(FTFontTest);
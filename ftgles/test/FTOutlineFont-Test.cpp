@@ -11,11 +11,19 @@
 
 extern void buildGLContext();
 
+static GLvoid RedCurrentColor(void* userData, GLfloat rgba[4])
+{
+    rgba[0] = 1.0f;
+    rgba[1] = rgba[2] = 0.0f;
+    rgba[3] = 1.0f;
+}
+
 class FTOutlineFontTest : public CppUnit::TestCase
 {
     CPPUNIT_TEST_SUITE(FTOutlineFontTest);
         CPPUNIT_TEST(testConstructor);
         CPPUNIT_TEST(testRender);
+        CPPUNIT_TEST(testColor);
         CPPUNIT_TEST(testBadDisplayList);
         CPPUNIT_TEST(testGoodDisplayList);
     CPPUNIT_TEST_SUITE_END();
@@ -60,6 +68,34 @@ class FTOutlineFontTest : public CppUnit::TestCase
             delete outlineFont;
         }
 
+        void testColor()
+        {
+            ftglesContext* context = ftglesCreateContext(0);
+            ftglesMakeCurrent(context);
+            ftglesBackend_t backend;
+            ftglesRecording_t recording;
+            ftglesInitRecordingBackend(&backend, &recording);
+            backend.currentColor = RedCurrentColor;
+            ftglesSetBackend(&backend);
+
+            // The outlines take the backend's current colour.
+            FTOutlineFont* outlineFont = new FTOutlineFont(FONT_FILE);
+            outlineFont->FaceSize(18);
+            outlineFont->Render(GOOD_ASCII_TEST_STRING);
+
+            GLubyte rgba[4];
+            ftglesGetColor(rgba);
+            CPPUNIT_ASSERT_EQUAL(255, (int)rgba[0]);
+            CPPUNIT_ASSERT_EQUAL(0, (int)rgba[1]);
+            CPPUNIT_ASSERT_EQUAL(0, (int)rgba[2]);
+            CPPUNIT_ASSERT_EQUAL(255, (int)rgba[3]);
+            CPPUNIT_ASSERT(recording.draws > 0);
+
+            delete outlineFont;
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
+        }
+
         void testBadDisplayList()
         {
             buildGLContext();
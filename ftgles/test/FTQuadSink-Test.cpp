@@ -0,0 +1,125 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+
+#include "Fontdefs.h"
+
+#include "FTGL/ftgles.h"
+#include "FTInternals.h"
+
+class FTQuadSinkTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTQuadSinkTest);
+        CPPUNIT_TEST(testQuadBuffer);
+        CPPUNIT_TEST(testRender);
+        CPPUNIT_TEST(testPosition);
+        CPPUNIT_TEST(testOtherFonts);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTQuadSinkTest() : CppUnit::TestCase("FTQuadSink Test")
+        {
+        }
+
+        FTQuadSinkTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testQuadBuffer()
+        {
+            FTGL::FTGLquad in[3];
+            FTGL::FTGLquad out[4];
+            in[0].page = 1;
+            in[1].page = 2;
+            in[2].page = 3;
+
+            FTQuadBuffer buffer(out, 4);
+            buffer.Quads(in, 3);
+            buffer.Quads(in, 3);
+
+            CPPUNIT_ASSERT_EQUAL(4u, buffer.Count());
+            CPPUNIT_ASSERT_EQUAL(6u, buffer.Needed());
+            CPPUNIT_ASSERT_EQUAL(3u, out[2].page);
+            CPPUNIT_ASSERT_EQUAL(1u, out[3].page);
+
+            buffer.Reset();
+            CPPUNIT_ASSERT_EQUAL(0u, buffer.Count());
+        }
+
+        void testRender()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->FaceSize(18);
+
+            FTGL::FTGLquad quads[64];
+            FTQuadBuffer buffer(quads, 64);
+            textureFont->Render("Hello", buffer);
+
+            CPPUNIT_ASSERT_EQUAL(5u, buffer.Needed());
+            CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(0u, recording.stateSaves);
+            CPPUNIT_ASSERT(quads[0].page != 0);
+            CPPUNIT_ASSERT(quads[0].x1 > quads[0].x0);
+            CPPUNIT_ASSERT(quads[0].y1 < quads[0].y0);
+            delete textureFont;
+        }
+
+        void testPosition()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->FaceSize(18);
+
+            FTGL::FTGLquad first[8], moved[8];
+            FTQuadBuffer a(first, 8), b(moved, 8);
+            FTPoint end = textureFont->Render("ab", a);
+            textureFont->Render("ab", b, -1, FTPoint(100.0, 50.0));
+
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(first[1].x0 + 100.0f, moved[1].x0, 0.01);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(first[1].y0 + 50.0f, moved[1].y0, 0.01);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(textureFont->Advance("ab"), end.Xf(), 0.01);
+            delete textureFont;
+        }
+
+        void testOtherFonts()
+        {
+            FTPolygonFont* polygonFont = new FTPolygonFont(FONT_FILE);
+            FTOutlineFont* outlineFont = new FTOutlineFont(FONT_FILE);
+            polygonFont->FaceSize(18);
+            outlineFont->FaceSize(18);
+
+            FTGL::FTGLquad quads[8];
+            FTQuadBuffer buffer(quads, 8);
+            FTPoint end = polygonFont->Render("ab", buffer, -1, FTPoint(5.0, 6.0));
+            outlineFont->Render("ab", buffer);
+
+            CPPUNIT_ASSERT_EQUAL(0u, buffer.Needed());
+            CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(0u, recording.vertices);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, end.Xf(), 0.01);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(6.0, end.Yf(), 0.01);
+            delete polygonFont;
+            delete outlineFont;
+        }
+
+        void setUp()
+        {
+            context = ftglesCreateContext(0);
+            ftglesMakeCurrent(context);
+            ftglesInitRecordingBackend(&backend, &recording);
+            ftglesSetBackend(&backend);
+        }
+
+        void tearDown()
+        {
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
+        }
+
+    private:
+        ftglesContext* context;
+        ftglesBackend_t backend;
+        ftglesRecording_t recording;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTQuadSinkTest);
+
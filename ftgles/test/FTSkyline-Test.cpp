@@ -0,0 +1,107 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+
+#include "Fontdefs.h"
+#include "FTGL/ftgles.h"
+#include "FTSkyline.h"
+
+
+class FTSkylineTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTSkylineTest);
+        CPPUNIT_TEST(testInsert);
+        CPPUNIT_TEST(testFull);
+        CPPUNIT_TEST(testOccupancy);
+        CPPUNIT_TEST(testTextureFont);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTSkylineTest() : CppUnit::TestCase("FTSkyline Test")
+        {}
+
+        FTSkylineTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testInsert()
+        {
+            FTSkyline skyline;
+            skyline.Reset(64, 64);
+            int x, y;
+
+            CPPUNIT_ASSERT(skyline.Insert(32, 16, x, y));
+            CPPUNIT_ASSERT_EQUAL(0, x);
+            CPPUNIT_ASSERT_EQUAL(0, y);
+
+            // Lands beside the first, on the floor.
+            CPPUNIT_ASSERT(skyline.Insert(16, 8, x, y));
+            CPPUNIT_ASSERT_EQUAL(32, x);
+            CPPUNIT_ASSERT_EQUAL(0, y);
+
+            // Too wide for the floor gap, so it rests on top.
+            CPPUNIT_ASSERT(skyline.Insert(40, 8, x, y));
+            CPPUNIT_ASSERT_EQUAL(0, x);
+            CPPUNIT_ASSERT_EQUAL(16, y);
+
+            // Fills the hole left beside the second rectangle.
+            CPPUNIT_ASSERT(skyline.Insert(24, 8, x, y));
+            CPPUNIT_ASSERT_EQUAL(40, x);
+            CPPUNIT_ASSERT_EQUAL(8, y);
+        }
+
+        void testFull()
+        {
+            FTSkyline skyline;
+            skyline.Reset(16, 16);
+            int x, y;
+
+            CPPUNIT_ASSERT(!skyline.Insert(17, 1, x, y));
+            CPPUNIT_ASSERT(!skyline.Insert(0, 1, x, y));
+
+            for(int i = 0; i < 16; ++i)
+            {
+                CPPUNIT_ASSERT(skyline.Insert(4, 4, x, y));
+            }
+            CPPUNIT_ASSERT(!skyline.Insert(1, 1, x, y));
+
+            skyline.Reset(16, 16);
+            CPPUNIT_ASSERT(skyline.Insert(16, 16, x, y));
+        }
+
+        void testOccupancy()
+        {
+            FTSkyline skyline;
+            int x, y;
+
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, skyline.Occupancy(), 0.001);
+
+            skyline.Reset(32, 32);
+            skyline.Insert(16, 16, x, y);
+            CPPUNIT_ASSERT_EQUAL(256l, skyline.UsedArea());
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25f, skyline.Occupancy(), 0.001);
+        }
+
+        void testTextureFont()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, textureFont->Occupancy(), 0.001);
+
+            textureFont->FaceSize(18);
+            textureFont->Advance(GOOD_ASCII_TEST_STRING);
+
+            float occupancy = textureFont->Occupancy();
+            CPPUNIT_ASSERT(occupancy > 0.0f);
+            CPPUNIT_ASSERT(occupancy <= 1.0f);
+
+            // A new size keeps the old size's glyphs, until it is dropped.
+            textureFont->FaceSize(24);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(occupancy, textureFont->Occupancy(), 0.001);
+            textureFont->CachedSizes(1);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0f, textureFont->Occupancy(), 0.001);
+            delete textureFont;
+        }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTSkylineTest);
+
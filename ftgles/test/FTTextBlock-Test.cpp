@@ -0,0 +1,248 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+
+#include "Fontdefs.h"
+
+#include "FTGL/ftgles.h"
+#include "FTInternals.h"
+
+
+class CountingFont : public FTTextureFont
+{
+    public:
+        CountingFont(const char* fontFilePath)
+        :   FTTextureFont(fontFilePath),
+            renders(0)
+        {}
+
+        virtual FTPoint Render(const char* string, const int len = -1,
+                               FTPoint position = FTPoint(),
+                               FTPoint spacing = FTPoint(),
+                               int renderMode = FTGL::RENDER_ALL)
+        {
+            renders++;
+            return FTTextureFont::Render(string, len, position, spacing,
+                                         renderMode);
+        }
+
+        virtual FTPoint Render(const wchar_t* string, const int len = -1,
+                               FTPoint position = FTPoint(),
+                               FTPoint spacing = FTPoint(),
+                               int renderMode = FTGL::RENDER_ALL)
+        {
+            renders++;
+            return FTTextureFont::Render(string, len, position, spacing,
+                                         renderMode);
+        }
+
+        unsigned int renders;
+};
+
+
+class FTTextBlockTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTTextBlockTest);
+        CPPUNIT_TEST(testReplay);
+        CPPUNIT_TEST(testSetText);
+        CPPUNIT_TEST(testFaceSize);
+        CPPUNIT_TEST(testEviction);
+        CPPUNIT_TEST(testSession);
+        CPPUNIT_TEST(testPolygonFont);
+        CPPUNIT_TEST(testCFunctions);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTTextBlockTest() : CppUnit::TestCase("FTTextBlock Test")
+        {
+        }
+
+        FTTextBlockTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testReplay()
+        {
+            CountingFont font(FONT_FILE);
+            font.FaceSize(18);
+
+            FTTextBlock block(&font, GOOD_ASCII_TEST_STRING);
+            FTPoint end = block.Render(FTPoint(10, 20));
+
+            CPPUNIT_ASSERT_EQUAL(1u, font.renders);
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(10 + font.Advance(GOOD_ASCII_TEST_STRING),
+                                         end.Xf(), 0.01);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(20, end.Yf(), 0.01);
+
+            // Drawn again from the recorded quads
+            unsigned int uploads = recording.uploads;
+            unsigned int vertices = recording.vertices;
+            block.Render(FTPoint(30, 40));
+
+            CPPUNIT_ASSERT_EQUAL(1u, font.renders);
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(uploads, recording.uploads);
+            CPPUNIT_ASSERT_EQUAL(vertices * 2, recording.vertices);
+        }
+
+        void testSetText()
+        {
+            CountingFont font(FONT_FILE);
+            font.FaceSize(18);
+
+            FTTextBlock block(&font, "ab");
+            block.Render();
+            CPPUNIT_ASSERT_EQUAL(1u, font.renders);
+
+            // The same text keeps the recording
+            block.SetText("ab");
+            block.Render();
+            CPPUNIT_ASSERT_EQUAL(1u, font.renders);
+
+            // Longer and shorter text is recorded again
+            const char* longer = "The quick brown fox jumps over the lazy dog";
+            block.SetText(longer);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(font.Advance(longer),
+                                         block.Advance().Xf(), 0.01);
+            CPPUNIT_ASSERT_EQUAL(2u, font.renders);
+
+            block.SetText("a");
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(font.Advance("a"),
+                                         block.Advance().Xf(), 0.01);
+            CPPUNIT_ASSERT_EQUAL(3u, font.renders);
+
+            // The same characters as wide text are recorded again
+            block.SetText(L"a");
+            block.Render();
+            CPPUNIT_ASSERT_EQUAL(4u, font.renders);
+
+            block.SetText((const char*)0);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0, block.Render().Xf(), 0.01);
+            CPPUNIT_ASSERT_EQUAL(4u, font.renders);
+        }
+
+        void testFaceSize()
+        {
+            CountingFont font(FONT_FILE);
+            font.FaceSize(18);
+
+            FTTextBlock block(&font, GOOD_ASCII_TEST_STRING);
+            float small = block.Render().Xf();
+
+            font.FaceSize(36);
+            float large = block.Render().Xf();
+
+            CPPUNIT_ASSERT_EQUAL(2u, font.renders);
+            CPPUNIT_ASSERT(large > small);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(font.Advance(GOOD_ASCII_TEST_STRING),
+                                         large, 0.01);
+        }
+
+        void testEviction()
+        {
+            CountingFont font(FONT_FILE);
+            font.PageSize(64);
+            font.PageBudget(1);
+            font.FaceSize(24);
+
+            FTTextBlock block(&font, "abc");
+            block.Render();
+            CPPUNIT_ASSERT_EQUAL(1u, font.renders);
+
+            // Filling the only page again evicts the block's glyphs
+            font.Render("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+            block.Render();
+            CPPUNIT_ASSERT_EQUAL(3u, font.renders);
+        }
+
+        void testSession()
+        {
+            CountingFont font(FONT_FILE);
+            font.FaceSize(18);
+
+            FTTextBlock first(&font, "abc");
+            FTTextBlock second(&font, "defg");
+
+            FTTextSession session;
+            session.Begin();
+                font.Render("xy");
+                first.Render();
+                second.Render(FTPoint(0, 20));
+                first.Render(FTPoint(0, 40));
+            session.End();
+
+            // Recording inside the session draws what the session has
+            // collected first, but never twice
+            CPPUNIT_ASSERT_EQUAL(3u, font.renders);
+            CPPUNIT_ASSERT_EQUAL((2u + 3u + 4u + 3u) * 4u, recording.vertices);
+
+            // Blocks already recorded go out with the session's quads
+            recording.draws = recording.vertices = 0;
+            session.Begin();
+                font.Render("xy");
+                first.Render();
+                second.Render(FTPoint(0, 20));
+                CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+            session.End();
+
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL((2u + 3u + 4u) * 4u, recording.vertices);
+        }
+
+        void testPolygonFont()
+        {
+            FTPolygonFont font(FONT_FILE);
+            font.FaceSize(18);
+
+            FTTextBlock block(&font, "abc");
+            FTPoint end = block.Render(FTPoint(10, 20));
+
+            CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(0u, recording.vertices);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(10, end.Xf(), 0.01);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(20, end.Yf(), 0.01);
+        }
+
+        void testCFunctions()
+        {
+            FTGL::FTGLfont* font = FTGL::ftglCreateTextureFont(FONT_FILE);
+            FTGL::ftglSetFontFaceSize(font, 18, 72);
+
+            FTGL::FTGLtextblock* block = FTGL::ftglCreateTextBlock(font);
+            FTGL::ftglSetTextBlockText(block, "abc");
+            FTGL::ftglRenderTextBlock(block, 0, 0);
+            FTGL::ftglRenderTextBlock(block, 0, 20);
+
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(2u * 3u * 4u, recording.vertices);
+
+            FTGL::ftglSetTextBlockFont(block, NULL);
+            FTGL::ftglRenderTextBlock(block, 0, 0);
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+
+            FTGL::ftglDestroyTextBlock(block);
+            FTGL::ftglDestroyFont(font);
+        }
+
+        void setUp()
+        {
+            context = ftglesCreateContext(0);
+            ftglesMakeCurrent(context);
+            ftglesInitRecordingBackend(&backend, &recording);
+            ftglesSetBackend(&backend);
+        }
+
+        void tearDown()
+        {
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
+        }
+
+    private:
+        ftglesContext* context;
+        ftglesBackend_t backend;
+        ftglesRecording_t recording;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTTextBlockTest);
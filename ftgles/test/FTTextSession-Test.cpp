@@ -0,0 +1,233 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+
+#include "Fontdefs.h"
+
+#include "FTGL/ftgles.h"
+#include "FTInternals.h"
+
+/*
+ * The first vertex of the first and second string in the last draw, each
+ * string being three glyphs.
+ */
+static ftglesVertex_t firstString, secondString;
+
+static GLvoid StringsDrawElements(void* userData,
+                                  const ftglesVertexArray_t* array,
+                                  const GLushort* indices, GLsizei count,
+                                  GLuint texture)
+{
+    ftglesRecording_t* recording = (ftglesRecording_t*)userData;
+
+    recording->draws++;
+    firstString = array->vertices[0];
+    secondString = array->vertices[3 * 4];
+}
+
+class FTTextSessionTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(FTTextSessionTest);
+        CPPUNIT_TEST(testFonts);
+        CPPUNIT_TEST(testState);
+        CPPUNIT_TEST(testTranslation);
+        CPPUNIT_TEST(testNested);
+        CPPUNIT_TEST(testContext);
+        CPPUNIT_TEST(testCFunctions);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        FTTextSessionTest() : CppUnit::TestCase("FTTextSession Test")
+        {
+        }
+
+        FTTextSessionTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testFonts()
+        {
+            FTTextureFont small(FONT_FILE);
+            FTTextureFont large(FONT_FILE);
+            FTBufferFont buffer(FONT_FILE);
+            small.FaceSize(18);
+            large.FaceSize(36);
+            buffer.FaceSize(18);
+
+            FTTextSession session;
+            session.Begin();
+                small.Render("abc");
+                large.Render("def", -1, FTPoint(0, 40));
+                small.Render("ghi", -1, FTPoint(0, 80));
+                buffer.Render("jkl", -1, FTPoint(0, 120));
+                large.Render("mno", -1, FTPoint(0, 160));
+                CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+            session.End();
+
+            // One draw per page, however the fonts were interleaved. The
+            // buffer font draws its string as a single quad.
+            CPPUNIT_ASSERT_EQUAL(recording.textures, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(3u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL((4u * 3u + 1u) * 4u, recording.vertices);
+        }
+
+        void testState()
+        {
+            FTTextureFont font(FONT_FILE);
+            font.FaceSize(18);
+
+            // Saving the text state and the client state both count
+            FTTextSession session;
+            session.Begin();
+                unsigned int saves = recording.stateSaves;
+                CPPUNIT_ASSERT(saves > 0);
+                for(int i = 0; i < 10; ++i)
+                {
+                    font.Render("abc", -1, FTPoint(0, i * 20));
+                }
+            session.End();
+
+            CPPUNIT_ASSERT_EQUAL(saves, recording.stateSaves);
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+            CPPUNIT_ASSERT(!session.Active());
+
+            // Without a session every string saves and draws on its own
+            font.Render("abc");
+            font.Render("abc");
+            CPPUNIT_ASSERT_EQUAL(3u * saves, recording.stateSaves);
+            CPPUNIT_ASSERT_EQUAL(3u, recording.draws);
+        }
+
+        void testTranslation()
+        {
+            FTTextureFont font(FONT_FILE);
+            font.FaceSize(18);
+            backend.drawElements = StringsDrawElements;
+            ftglesSetBackend(&backend);
+
+            // A translation between strings never reaches their vertices,
+            // and both are drawn under the matrix current at End().
+            FTTextSession session;
+            session.Begin();
+                font.Render("abc");
+                glTranslatef(0.0f, 40.0f, 0.0f);
+                font.Render("abc");
+                glTranslatef(0.0f, -40.0f, 0.0f);
+            session.End();
+
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(firstString.xyz[0], secondString.xyz[0]);
+            CPPUNIT_ASSERT_EQUAL(firstString.xyz[1], secondString.xyz[1]);
+
+            // The position passed to Render is baked in.
+            session.Begin();
+                font.Render("abc");
+                font.Render("abc", -1, FTPoint(0, 40));
+            session.End();
+
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(firstString.xyz[0], secondString.xyz[0]);
+            CPPUNIT_ASSERT_EQUAL(firstString.xyz[1] + 40.0f,
+                                 secondString.xyz[1]);
+        }
+
+        void testNested()
+        {
+            FTTextureFont font(FONT_FILE);
+            font.FaceSize(18);
+
+            FTTextSession outer, inner;
+            outer.Begin();
+                unsigned int saves = recording.stateSaves;
+                font.Render("abc");
+                inner.Begin();
+                    font.Render("def");
+                inner.End();
+                CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+                font.Render("ghi");
+            outer.End();
+
+            CPPUNIT_ASSERT_EQUAL(saves, recording.stateSaves);
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(3u * 3u * 4u, recording.vertices);
+        }
+
+        void testContext()
+        {
+            ftglesContext* other = ftglesCreateContext(0);
+            ftglesMakeCurrent(other);
+            ftglesBackend_t otherBackend;
+            ftglesRecording_t otherRecording;
+            ftglesInitRecordingBackend(&otherBackend, &otherRecording);
+            ftglesSetBackend(&otherBackend);
+            ftglesMakeCurrent(context);
+
+            FTTextureFont font(FONT_FILE);
+            font.FaceSize(18);
+
+            // The session's context is current only while it is active
+            FTTextSession session(other);
+            session.Begin();
+                CPPUNIT_ASSERT(ftglesGetCurrentContext() == other);
+                font.Render("abc");
+            session.End();
+
+            CPPUNIT_ASSERT(ftglesGetCurrentContext() == context);
+            CPPUNIT_ASSERT_EQUAL(1u, otherRecording.draws);
+            CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+
+            ftglesDestroyContext(other);
+        }
+
+        void testCFunctions()
+        {
+            FTGL::FTGLfont* small = FTGL::ftglCreateTextureFont(FONT_FILE);
+            FTGL::FTGLfont* large = FTGL::ftglCreateTextureFont(FONT_FILE);
+            FTGL::ftglSetFontFaceSize(small, 18, 72);
+            FTGL::ftglSetFontFaceSize(large, 36, 72);
+
+            FTGL::FTGLsession* session = FTGL::ftglCreateTextSession();
+            FTGL::ftglBeginTextSession(session);
+                unsigned int saves = recording.stateSaves;
+                FTGL::ftglSetTextSessionColor(session, 1.0f, 0.0f, 0.0f, 1.0f);
+                FTGL::ftglRenderFont(small, "abc", FTGL::RENDER_ALL);
+                FTGL::ftglRenderFont(large, "abc", FTGL::RENDER_ALL);
+                FTGL::ftglRenderFont(small, "def", FTGL::RENDER_ALL);
+                CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+            FTGL::ftglEndTextSession(session);
+
+            CPPUNIT_ASSERT_EQUAL(saves, recording.stateSaves);
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(3u * 3u * 4u, recording.vertices);
+
+            // Destroying an active session ends it
+            FTGL::ftglBeginTextSession(session);
+                FTGL::ftglRenderFont(small, "abc", FTGL::RENDER_ALL);
+            FTGL::ftglDestroyTextSession(session);
+            CPPUNIT_ASSERT_EQUAL(3u, recording.draws);
+
+            FTGL::ftglDestroyFont(small);
+            FTGL::ftglDestroyFont(large);
+        }
+
+        void setUp()
+        {
+            context = ftglesCreateContext(0);
+            ftglesMakeCurrent(context);
+            ftglesInitRecordingBackend(&backend, &recording);
+            ftglesSetBackend(&backend);
+        }
+
+        void tearDown()
+        {
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
+        }
+
+    private:
+        ftglesContext* context;
+        ftglesBackend_t backend;
+        ftglesRecording_t recording;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FTTextSessionTest);
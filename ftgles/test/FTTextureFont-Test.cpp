@@ -3,6 +3,8 @@
 #include <cppunit/TestCase.h>
 #include <cppunit/TestSuite.h>
 #include <assert.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "Fontdefs.h"
 
@@ -11,6 +13,24 @@
 
 extern void buildGLContext();
 
+/*
+ * Keeps how many uploads the recording backend had made by its first draw.
+ */
+static unsigned int uploadsAtFirstDraw;
+
+static GLvoid FirstDrawElements(void* userData,
+                                const ftglesVertexArray_t* array,
+                                const GLushort* indices, GLsizei count,
+                                GLuint texture)
+{
+    ftglesRecording_t* recording = (ftglesRecording_t*)userData;
+
+    if(recording->draws++ == 0)
+    {
+        uploadsAtFirstDraw = recording->uploads;
+    }
+}
+
 class FTTextureFontTest : public CppUnit::TestCase
 {
     CPPUNIT_TEST_SUITE(FTTextureFontTest);
@@ -18,6 +38,15 @@ class FTTextureFontTest : public CppUnit::TestCase
         CPPUNIT_TEST(testResizeBug);
         CPPUNIT_TEST(testRender);
         CPPUNIT_TEST(testDisplayList);
+        CPPUNIT_TEST(testPageBudget);
+        CPPUNIT_TEST(testOversizedGlyph);
+        CPPUNIT_TEST(testBatchedUploads);
+        CPPUNIT_TEST(testBatchedUploadsLongString);
+        CPPUNIT_TEST(testCache);
+        CPPUNIT_TEST(testCacheReproducible);
+        CPPUNIT_TEST(testCacheRevisedFont);
+        CPPUNIT_TEST(testSubpixel);
+        CPPUNIT_TEST(testSubpixelEviction);
     CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -94,13 +123,339 @@ class FTTextureFontTest : public CppUnit::TestCase
             delete textureFont;
         }
 
+        void testPageBudget()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->PageSize(5000);
+            textureFont->FaceSize(18);
+
+            // Limited to the backend's largest texture.
+            textureFont->Render("a");
+            CPPUNIT_ASSERT_EQUAL(1u, textureFont->PageCount());
+            CPPUNIT_ASSERT(recording.uploadBytes > 2048ul * 2048ul);
+            CPPUNIT_ASSERT(recording.uploadBytes < 2048ul * 2048ul + 2048ul * 32);
+
+            // Not keeping the old size starts the pages again.
+            textureFont->CachedSizes(1);
+            textureFont->PageSize(64);
+            textureFont->PageBudget(2);
+            textureFont->FaceSize(24);
+
+            const char* alphabet = "abcdefghijklmnopqrstuvwxyz"
+                                   "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+            textureFont->Render(alphabet);
+            textureFont->Render(alphabet);
+
+            // Pages are reused rather than added.
+            CPPUNIT_ASSERT_EQUAL(2u, textureFont->PageCount());
+            CPPUNIT_ASSERT_EQUAL(3u, recording.textures);
+            CPPUNIT_ASSERT(textureFont->Occupancy() > 0.0f);
+
+            float advance = textureFont->Advance(alphabet);
+            FTPoint pen = textureFont->Render(alphabet);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(advance, pen.Xf(), 0.01);
+            delete textureFont;
+        }
+
+        void testOversizedGlyph()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->PageSize(64);
+            textureFont->FaceSize(96);
+
+            // Small glyphs after a large one
+            const char* text = "W.-,W";
+            FTGL::FTGLquad quads[5];
+            FTQuadBuffer buffer(quads, 5);
+            textureFont->Render(text, buffer);
+
+            // Glyphs larger than a page get a page of their own, and
+            // nothing is packed over them
+            for(int i = 0; i < 5; ++i)
+            {
+                CPPUNIT_ASSERT(quads[i].s1 - quads[i].s0 > 0.0f);
+                CPPUNIT_ASSERT(quads[i].t1 - quads[i].t0 > 0.0f);
+
+                for(int j = 0; j < i; ++j)
+                {
+                    if(quads[i].page != quads[j].page || text[i] == text[j])
+                    {
+                        continue;
+                    }
+
+                    CPPUNIT_ASSERT(quads[i].s0 >= quads[j].s1
+                                   || quads[j].s0 >= quads[i].s1
+                                   || quads[i].t0 >= quads[j].t1
+                                   || quads[j].t0 >= quads[i].t1);
+                }
+            }
+
+            // Not cut down to the page size
+            FTBBox box = textureFont->BBox("W");
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(box.Upper().Xf() - box.Lower().Xf(),
+                                         quads[0].x1 - quads[0].x0, 2.0);
+
+            delete textureFont;
+        }
+
+        void testBatchedUploads()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->PageSize(256);
+            textureFont->FaceSize(18);
+
+            // One page image, then one upload for the whole string.
+            textureFont->Render("abcdefghijklmnopqrstuvwxyz");
+            CPPUNIT_ASSERT_EQUAL(2u, recording.uploads);
+
+            CPPUNIT_ASSERT(textureFont->Preload(' ', '~') > 0);
+            CPPUNIT_ASSERT_EQUAL(3u, recording.uploads);
+
+            // Nothing new: nothing uploaded.
+            textureFont->Render("The quick brown fox");
+            CPPUNIT_ASSERT_EQUAL(3u, recording.uploads);
+
+            // Measuring makes glyphs one at a time.
+            textureFont->Advance("\xc3\xa9");
+            CPPUNIT_ASSERT_EQUAL(4u, recording.uploads);
+
+            delete textureFont;
+        }
+
+        void testBatchedUploadsLongString()
+        {
+            // The string is drawn in parts, the first once the batch fills
+            ftglesContext* small = ftglesCreateContext(64);
+            ftglesMakeCurrent(small);
+            backend.drawElements = FirstDrawElements;
+            ftglesSetBackend(&backend);
+
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->PageSize(256);
+            textureFont->FaceSize(18);
+            textureFont->Render("abcdefghijklmnopqrstuvwxyz");
+
+            CPPUNIT_ASSERT(recording.draws > 1);
+            CPPUNIT_ASSERT_EQUAL(2u, recording.uploads);
+            CPPUNIT_ASSERT_EQUAL(2u, uploadsAtFirstDraw);
+
+            delete textureFont;
+            ftglesMakeCurrent(context);
+            ftglesDestroyContext(small);
+        }
+
+        void testCache()
+        {
+            const char* path = "ftgles-cache-test.dat";
+            const char* text = "The quick brown fox, 0123456789!";
+
+            FTTextureFont* saved = new FTTextureFont(FONT_FILE);
+            CPPUNIT_ASSERT(!saved->SaveCache(path));
+            saved->FaceSize(18);
+            saved->Preload(' ', '~');
+            CPPUNIT_ASSERT(saved->SaveCache(path));
+            float advance = saved->Advance(text);
+            delete saved;
+
+            // Another size is refused.
+            FTTextureFont* other = new FTTextureFont(FONT_FILE);
+            other->FaceSize(24);
+            CPPUNIT_ASSERT(!other->LoadCache(path));
+            delete other;
+
+            FTTextureFont* loaded = new FTTextureFont(FONT_FILE);
+            loaded->FaceSize(18);
+
+            unsigned int uploads = recording.uploads;
+            CPPUNIT_ASSERT(loaded->LoadCache(path));
+            CPPUNIT_ASSERT_EQUAL(1u, loaded->PageCount());
+            CPPUNIT_ASSERT_EQUAL(uploads + 1, recording.uploads);
+
+            // Nothing is rasterised or uploaded again.
+            CPPUNIT_ASSERT_EQUAL(0u, loaded->Preload(' ', '~'));
+            FTPoint pen = loaded->Render(text);
+            CPPUNIT_ASSERT_EQUAL(uploads + 1, recording.uploads);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(advance, pen.Xf(), 0.01);
+
+            // Characters outside the file are made as usual.
+            CPPUNIT_ASSERT_EQUAL(1u, loaded->Preload("\xc3\xa9"));
+
+            delete loaded;
+            remove(path);
+        }
+
+        void testCacheReproducible()
+        {
+            const char* paths[2] = { "ftgles-cache-a.dat",
+                                     "ftgles-cache-b.dat" };
+
+            for(int i = 0; i < 2; ++i)
+            {
+                FTTextureFont* font = new FTTextureFont(FONT_FILE);
+                font->FaceSize(18);
+                font->Preload(GOOD_ASCII_TEST_STRING);
+                CPPUNIT_ASSERT(font->SaveCache(paths[i]));
+                delete font;
+            }
+
+            // Baking the same glyphs twice writes the same bytes.
+            FILE* a = fopen(paths[0], "rb");
+            FILE* b = fopen(paths[1], "rb");
+            int ca, cb;
+            long size = 0;
+            do
+            {
+                ca = fgetc(a);
+                cb = fgetc(b);
+                CPPUNIT_ASSERT_EQUAL(ca, cb);
+                ++size;
+            }
+            while(ca != EOF);
+            fclose(a);
+            fclose(b);
+
+            CPPUNIT_ASSERT(size > 1);
+            remove(paths[0]);
+            remove(paths[1]);
+        }
+
+        void testCacheRevisedFont()
+        {
+            const char* path = "ftgles-cache-revised.dat";
+
+            FILE* file = fopen(FONT_FILE, "rb");
+            CPPUNIT_ASSERT(file != NULL);
+            fseek(file, 0, SEEK_END);
+            long size = ftell(file);
+            fseek(file, 0, SEEK_SET);
+            unsigned char* data = new unsigned char[size];
+            CPPUNIT_ASSERT_EQUAL(1, (int)fread(data, size, 1, file));
+            fclose(file);
+
+            FTTextureFont* original = new FTTextureFont(data, size);
+            original->FaceSize(18);
+            original->Preload(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT(original->SaveCache(path));
+            delete original;
+
+            // The same font file is accepted
+            FTTextureFont* same = new FTTextureFont(FONT_FILE);
+            same->FaceSize(18);
+            CPPUNIT_ASSERT(same->LoadCache(path));
+            delete same;
+
+            // A later revision of the font, with the same names and glyphs,
+            // is refused
+            int tables = (data[4] << 8) | data[5];
+            for(int i = 0; i < tables; ++i)
+            {
+                const unsigned char* entry = data + 12 + 16 * i;
+                if(memcmp(entry, "head", 4) == 0)
+                {
+                    long offset = (entry[8] << 24) | (entry[9] << 16)
+                                | (entry[10] << 8) | entry[11];
+                    data[offset + 5]++; // fontRevision
+                }
+            }
+
+            FTTextureFont* revised = new FTTextureFont(data, size);
+            revised->FaceSize(18);
+            CPPUNIT_ASSERT(!revised->LoadCache(path));
+            delete revised;
+
+            delete[] data;
+            remove(path);
+        }
+
+        void testSubpixel()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->FaceSize(18);
+            textureFont->SubpixelPositions(4);
+
+            const float x[5] = { 0.0f, 0.1f, 0.25f, 0.5f, 1.0f };
+            FTGL::FTGLquad quads[5];
+            for(int i = 0; i < 5; ++i)
+            {
+                FTQuadBuffer buffer(&quads[i], 1);
+                textureFont->Render("o", buffer, -1, FTPoint(x[i], 0.0));
+            }
+
+            // Near a whole pixel the whole pixel image is used.
+            CPPUNIT_ASSERT_EQUAL(quads[0].s0, quads[1].s0);
+            CPPUNIT_ASSERT_EQUAL(quads[0].x0, quads[1].x0);
+            CPPUNIT_ASSERT_EQUAL(quads[0].s0, quads[4].s0);
+            CPPUNIT_ASSERT_EQUAL(quads[0].x0 + 1.0f, quads[4].x0);
+
+            // Between pixels, an image per phase.
+            CPPUNIT_ASSERT(quads[2].s0 != quads[0].s0);
+            CPPUNIT_ASSERT(quads[3].s0 != quads[0].s0);
+            CPPUNIT_ASSERT(quads[3].s0 != quads[2].s0);
+
+            // Drawn again, the phases are not made again.
+            unsigned int uploads = recording.uploads;
+            FTGL::FTGLquad again;
+            FTQuadBuffer buffer(&again, 1);
+            textureFont->Render("o", buffer, -1, FTPoint(10.5, 0.0));
+            CPPUNIT_ASSERT_EQUAL(uploads, recording.uploads);
+            CPPUNIT_ASSERT_EQUAL(quads[3].s0, again.s0);
+            CPPUNIT_ASSERT_EQUAL(quads[3].x0 + 10.0f, again.x0);
+
+            // Whole pixels only.
+            textureFont->SubpixelPositions(1);
+            for(int i = 0; i < 3; i += 2)
+            {
+                FTQuadBuffer buffer(&quads[i], 1);
+                textureFont->Render("o", buffer, -1, FTPoint(x[i], 0.0));
+            }
+            CPPUNIT_ASSERT_EQUAL(quads[0].s0, quads[2].s0);
+
+            delete textureFont;
+        }
+
+        void testSubpixelEviction()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->PageSize(64);
+            textureFont->PageBudget(2);
+            textureFont->FaceSize(24);
+            textureFont->SubpixelPositions(4);
+
+            // The phases of a glyph land on different pages, and evicting
+            // any of them unloads the whole glyph.
+            const char* alphabet = "abcdefghijklmnopqrstuvwxyz"
+                                   "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+            float advance = textureFont->Advance(alphabet);
+            for(int i = 0; i < 4; ++i)
+            {
+                FTPoint pen = textureFont->Render(alphabet, -1,
+                                                  FTPoint(i * 0.25, 0.0));
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(advance + i * 0.25, pen.Xf(), 0.01);
+            }
+
+            CPPUNIT_ASSERT_EQUAL(2u, textureFont->PageCount());
+            CPPUNIT_ASSERT(textureFont->Occupancy() > 0.0f);
+            delete textureFont;
+        }
+
         void setUp()
-        {}
+        {
+            context = ftglesCreateContext(0);
+            ftglesMakeCurrent(context);
+            ftglesInitRecordingBackend(&backend, &recording);
+            ftglesSetBackend(&backend);
+        }
 
         void tearDown()
-        {}
+        {
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
+        }
 
     private:
+        ftglesContext* context;
+        ftglesBackend_t backend;
+        ftglesRecording_t recording;
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(FTTextureFontTest);
@@ -0,0 +1,398 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "Fontdefs.h"
+
+#include "FTGL/ftgles.h"
+#include "FTInternals.h"
+
+/*
+ * Writes batches of quads at x = *id into a capture on a context of its own.
+ */
+static void* BatchThread(void* id)
+{
+    float x = *(float*)id;
+    ftglesContext* context = ftglesCreateContext(64);
+    ftglesMakeCurrent(context);
+
+    ftglesCapture_t* capture = new ftglesCapture_t;
+    memset(capture, 0, sizeof(*capture));
+
+    ftglesBeginCapture(capture);
+    for(int i = 0; i < 20000; ++i)
+    {
+        ftglBegin(GL_QUADS);
+            ftglBindTexture(1);
+            for(int j = 0; j < 16; ++j)
+            {
+                ftglColor4ub(0, 0, 0, 255);
+                ftglVertex2f(x, j);
+            }
+        ftglEnd();
+    }
+    ftglesEndCapture();
+
+    ftglesMakeCurrent(NULL);
+    ftglesDestroyContext(context);
+    return capture;
+}
+
+
+/*
+ * Keeps the first packed position of the last quad batch drawn.
+ */
+static GLshort packedPosition[2];
+
+static GLvoid PackedDraw(void* userData, const ftglesVertexArray_t* array,
+                         const GLushort* indices, GLsizei count,
+                         GLuint texture)
+{
+    memcpy(packedPosition, array->packed, sizeof(packedPosition));
+}
+
+
+class ftglesGlueTest : public CppUnit::TestCase
+{
+    CPPUNIT_TEST_SUITE(ftglesGlueTest);
+        CPPUNIT_TEST(testQuadBatch);
+        CPPUNIT_TEST(testTextureSplit);
+        CPPUNIT_TEST(testFlush);
+        CPPUNIT_TEST(testPartialQuadFlush);
+        CPPUNIT_TEST(testSession);
+        CPPUNIT_TEST(testSessionCapture);
+        CPPUNIT_TEST(testThreads);
+        CPPUNIT_TEST(testTextureFont);
+        CPPUNIT_TEST(testVertexFormat);
+        CPPUNIT_TEST(testColorRuns);
+        CPPUNIT_TEST(testPolygonFont);
+    CPPUNIT_TEST_SUITE_END();
+
+    public:
+        ftglesGlueTest() : CppUnit::TestCase("ftglesGlue Test")
+        {
+        }
+
+        ftglesGlueTest(const std::string& name) : CppUnit::TestCase(name) {}
+
+        void testQuadBatch()
+        {
+            ftglBegin(GL_QUADS);
+                ftglBindTexture(1);
+                Quads(10);
+            ftglEnd();
+
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(40u, recording.vertices);
+            CPPUNIT_ASSERT_EQUAL(60u, recording.indices);
+        }
+
+        void testThreads()
+        {
+            float ids[2] = { 1.0f, 2.0f };
+            pthread_t threads[2];
+
+            for(int t = 0; t < 2; ++t)
+            {
+                pthread_create(&threads[t], NULL, BatchThread, &ids[t]);
+            }
+
+            // Each thread's batches stay on its own context
+            for(int t = 0; t < 2; ++t)
+            {
+                void* result;
+                pthread_join(threads[t], &result);
+                ftglesCapture_t* capture = (ftglesCapture_t*)result;
+
+                CPPUNIT_ASSERT_EQUAL(20000u * 16u, capture->count);
+                unsigned int other = 0;
+                for(unsigned int i = 0; i < capture->count; ++i)
+                {
+                    other += capture->vertices[i].xyz[0] != ids[t];
+                }
+                CPPUNIT_ASSERT_EQUAL(0u, other);
+
+                ftglesFreeCapture(capture);
+                delete capture;
+            }
+
+            CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+        }
+
+        void testTextureSplit()
+        {
+            ftglBegin(GL_QUADS);
+            for(int i = 0; i < 12; ++i)
+            {
+                ftglBindTexture(i % 3 + 1);
+                Quads(1);
+            }
+            ftglEnd();
+
+            CPPUNIT_ASSERT_EQUAL(3u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(72u, recording.indices);
+        }
+
+        void testFlush()
+        {
+            ftglBegin(GL_QUADS);
+                ftglBindTexture(1);
+                Quads(100);
+            ftglEnd();
+
+            // 64 vertices per batch: 16 quads a draw.
+            CPPUNIT_ASSERT_EQUAL(7u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(400u, recording.vertices);
+
+            recording.draws = recording.vertices = 0;
+
+            ftglBegin(GL_TRIANGLE_FAN);
+            for(int i = 0; i < 100; ++i)
+            {
+                ftglVertex2f(i, i);
+            }
+            ftglEnd();
+
+            // Each flush carries the centre and the last vertex on.
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(102u, recording.vertices);
+        }
+
+        void testPartialQuadFlush()
+        {
+            // A quad cut by a flush keeps its texture.
+            ftglBegin(GL_QUADS);
+                ftglBindTexture(1);
+                Quads(1);
+                ftglBindTexture(2);
+                ftglVertex2f(0.0f, 0.0f);
+                ftglVertex2f(1.0f, 0.0f);
+                ftglesFlush();
+                CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+                ftglVertex2f(1.0f, 1.0f);
+                ftglVertex2f(0.0f, 1.0f);
+            ftglEnd();
+
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(8u, recording.vertices);
+            CPPUNIT_ASSERT_EQUAL(2u, recording.texture);
+        }
+
+        void testSession()
+        {
+            ftglesBeginSession();
+            for(int i = 0; i < 10; ++i)
+            {
+                ftglBegin(GL_QUADS);
+                    ftglBindTexture(i % 2 + 1);
+                    Quads(1);
+                ftglEnd();
+            }
+            CPPUNIT_ASSERT_EQUAL(0u, recording.draws);
+            ftglesEndSession();
+
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(40u, recording.vertices);
+            CPPUNIT_ASSERT_EQUAL(2u, recording.stateSaves);
+        }
+
+        void testSessionCapture()
+        {
+            ftglesCapture_t capture;
+            memset(&capture, 0, sizeof(capture));
+
+            ftglesBeginSession();
+                ftglBegin(GL_QUADS);
+                    ftglBindTexture(1);
+                    Quads(5);
+                ftglEnd();
+
+                // The quads collected so far are drawn once, not again
+                // when the capture starts its own batch.
+                ftglesBeginCapture(&capture);
+                CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+                CPPUNIT_ASSERT_EQUAL(20u, recording.vertices);
+
+                ftglBegin(GL_QUADS);
+                    Quads(3);
+                ftglEnd();
+                ftglesEndCapture();
+            ftglesEndSession();
+
+            CPPUNIT_ASSERT_EQUAL(12u, capture.count);
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(20u, recording.vertices);
+            ftglesFreeCapture(&capture);
+        }
+
+        void testTextureFont()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->FaceSize(18);
+
+            textureFont->Render(GOOD_ASCII_TEST_STRING);
+            unsigned int uploads = recording.uploads;
+
+            CPPUNIT_ASSERT(recording.textures > 0);
+            CPPUNIT_ASSERT(uploads > 0);
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+
+            textureFont->Render(GOOD_ASCII_TEST_STRING);
+
+            CPPUNIT_ASSERT_EQUAL(uploads, recording.uploads);
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+            delete textureFont;
+        }
+
+        void testVertexFormat()
+        {
+            CPPUNIT_ASSERT_EQUAL(24, (int)ftglesVertexStride(FTGLES_VERTEX_FLOAT));
+            CPPUNIT_ASSERT_EQUAL(16, (int)ftglesVertexStride(FTGLES_VERTEX_COMPACT));
+            CPPUNIT_ASSERT_EQUAL(12, (int)ftglesVertexStride(FTGLES_VERTEX_SHORT));
+            CPPUNIT_ASSERT_EQUAL(8, (int)ftglesVertexStride(FTGLES_VERTEX_SHORT | FTGLES_VERTEX_UNIFORM_COLOR));
+
+            ftglesSetVertexFormat(FTGLES_VERTEX_SHORT);
+            ftglBegin(GL_QUADS);
+                ftglBindTexture(1);
+                Quads(10);
+            ftglEnd();
+
+            CPPUNIT_ASSERT_EQUAL(480ul, recording.vertexBytes);
+
+            // Switching layout inside a session draws what was collected.
+            ftglesBeginSession();
+                ftglBegin(GL_QUADS);
+                    Quads(10);
+                ftglEnd();
+                ftglesSetVertexFormat(FTGLES_VERTEX_FLOAT);
+                CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+                ftglBegin(GL_QUADS);
+                    Quads(10);
+                ftglEnd();
+            ftglesEndSession();
+
+            CPPUNIT_ASSERT_EQUAL(3u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(960ul + 960ul, recording.vertexBytes);
+
+            // Short positions are rounded, not truncated
+            backend.drawElements = PackedDraw;
+            ftglesSetVertexFormat(FTGLES_VERTEX_SHORT);
+            ftglBegin(GL_QUADS);
+                ftglBindTexture(1);
+                for(int i = 0; i < 4; ++i)
+                {
+                    ftglVertex2f(10.6f, -3.6f);
+                }
+            ftglEnd();
+
+            CPPUNIT_ASSERT_EQUAL(11, (int)packedPosition[0]);
+            CPPUNIT_ASSERT_EQUAL(-4, (int)packedPosition[1]);
+        }
+
+        void testColorRuns()
+        {
+            FTTextureFont* textureFont = new FTTextureFont(FONT_FILE);
+            textureFont->FaceSize(18);
+
+            FTGL::FTGLcolorrun runs[2] = {{1, {255, 0, 0, 255}},
+                                          {2, {0, 0, 255, 128}}};
+            ftglesCapture_t capture;
+            memset(&capture, 0, sizeof(capture));
+
+            ftglColor4ub(0, 255, 0, 255);
+            ftglesBeginCapture(&capture);
+                textureFont->Render("abc", runs, 2);
+            ftglesEndCapture();
+
+            CPPUNIT_ASSERT_EQUAL(12u, capture.count);
+            CPPUNIT_ASSERT_EQUAL(255, (int)capture.vertices[0].rgba[1]);
+            CPPUNIT_ASSERT_EQUAL(255, (int)capture.vertices[4].rgba[0]);
+            CPPUNIT_ASSERT_EQUAL(255, (int)capture.vertices[11].rgba[2]);
+            CPPUNIT_ASSERT_EQUAL(128, (int)capture.vertices[11].rgba[3]);
+
+            // The colour in effect before the call is put back.
+            GLubyte rgba[4];
+            ftglesGetColor(rgba);
+            CPPUNIT_ASSERT_EQUAL(255, (int)rgba[1]);
+            ftglesFreeCapture(&capture);
+
+            // All runs go out in one draw.
+            textureFont->Render("abc", runs, 2);
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+            delete textureFont;
+        }
+
+        void testPolygonFont()
+        {
+            ftglesContext* large = ftglesCreateContext(0);
+            ftglesMakeCurrent(large);
+            ftglesSetBackend(&backend);
+
+            FTPolygonFont* polygonFont = new FTPolygonFont(FONT_FILE);
+            polygonFont->FaceSize(18);
+
+            // Each string is one triangle list.
+            polygonFont->Render(GOOD_ASCII_TEST_STRING);
+            CPPUNIT_ASSERT_EQUAL(1u, recording.draws);
+            CPPUNIT_ASSERT(recording.vertices > 0);
+            CPPUNIT_ASSERT_EQUAL(0u, recording.vertices % 3);
+
+            polygonFont->Render("ab");
+            CPPUNIT_ASSERT_EQUAL(2u, recording.draws);
+
+            // Drawn untextured after a textured batch
+            ftglBegin(GL_QUADS);
+                ftglBindTexture(1);
+                Quads(1);
+            ftglEnd();
+            CPPUNIT_ASSERT_EQUAL(1u, recording.texture);
+
+            polygonFont->Render("ab");
+            CPPUNIT_ASSERT_EQUAL(4u, recording.draws);
+            CPPUNIT_ASSERT_EQUAL(0u, recording.texture);
+
+            delete polygonFont;
+            ftglesMakeCurrent(context);
+            ftglesDestroyContext(large);
+        }
+
+        void setUp()
+        {
+            context = ftglesCreateContext(64);
+            ftglesMakeCurrent(context);
+            ftglesInitRecordingBackend(&backend, &recording);
+            ftglesSetBackend(&backend);
+        }
+
+        void tearDown()
+        {
+            ftglesMakeCurrent(NULL);
+            ftglesDestroyContext(context);
+        }
+
+    private:
+        ftglesContext* context;
+        ftglesBackend_t backend;
+        ftglesRecording_t recording;
+
+        void Quads(int count)
+        {
+            for(int i = 0; i < count; ++i)
+            {
+                ftglTexCoord2f(0.0f, 0.0f);
+                ftglVertex2f(i, 0.0f);
+                ftglTexCoord2f(0.0f, 1.0f);
+                ftglVertex2f(i, 1.0f);
+                ftglTexCoord2f(1.0f, 1.0f);
+                ftglVertex2f(i + 1, 1.0f);
+                ftglTexCoord2f(1.0f, 0.0f);
+                ftglVertex2f(i + 1, 0.0f);
+            }
+        }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ftglesGlueTest);
+
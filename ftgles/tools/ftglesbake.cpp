@@ -0,0 +1,224 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+/*
+ * ftglesbake - rasterises a font's glyphs ahead of time into the cache
+ * files FTTextureFont::LoadCache reads, so a device loading them makes no
+ * glyphs for the characters they cover.
+ *
+ * Glyphs are made with a recording backend, so no GL context is needed.
+ * A file is only good for the face, size and load flags it was baked at;
+ * bake with the same FTTextureFont settings the application uses.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "FTGL/ftgles.h"
+#include "FTGL/ftglesGlue.h"
+
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-s sizes] [-c charset] [-d reference] [-p page]\n"
+            "       [-o prefix] font\n"
+            "\n"
+            "  -s sizes      comma separated point sizes (default 12)\n"
+            "  -c charset    UTF-8 file of the characters to bake\n"
+            "                (default printable ASCII)\n"
+            "  -d reference  bake distance fields at this size\n"
+            "  -p page       texture page edge length in texels\n"
+            "  -o prefix     write <prefix>-<size>.ftc (default: the font\n"
+            "                path without its extension)\n",
+            name);
+}
+
+
+/*
+ * Read a charset file, dropping line breaks and other control characters
+ * so they are not baked as missing glyphs.
+ */
+static char *readCharset(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if(!file)
+    {
+        return NULL;
+    }
+
+    size_t size = 0, capacity = 4096;
+    char *text = (char *)malloc(capacity);
+    int c;
+
+    while(text && (c = fgetc(file)) != EOF)
+    {
+        if(c < 0x20 || c == 0x7f)
+        {
+            continue;
+        }
+
+        if(size + 1 >= capacity)
+        {
+            capacity *= 2;
+            char *grown = (char *)realloc(text, capacity);
+            if(!grown)
+            {
+                free(text);
+                text = NULL;
+                break;
+            }
+            text = grown;
+        }
+        text[size++] = static_cast<char>(c);
+    }
+
+    fclose(file);
+
+    if(text)
+    {
+        text[size] = '\0';
+    }
+    return text;
+}
+
+
+int main(int argc, char **argv)
+{
+    const char *sizes = "12";
+    const char *charsetPath = NULL;
+    const char *prefix = NULL;
+    unsigned int reference = 0;
+    unsigned int pageSize = 0;
+    int opt;
+
+    while((opt = getopt(argc, argv, "s:c:d:p:o:h")) != -1)
+    {
+        switch(opt)
+        {
+            case 's': sizes = optarg; break;
+            case 'c': charsetPath = optarg; break;
+            case 'd': reference = strtoul(optarg, NULL, 10); break;
+            case 'p': pageSize = strtoul(optarg, NULL, 10); break;
+            case 'o': prefix = optarg; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if(optind != argc - 1)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char *fontPath = argv[optind];
+
+    char *charset = NULL;
+    if(charsetPath)
+    {
+        charset = readCharset(charsetPath);
+        if(!charset)
+        {
+            fprintf(stderr, "%s: cannot read %s\n", argv[0], charsetPath);
+            return EXIT_FAILURE;
+        }
+    }
+
+    char *base = NULL;
+    if(!prefix)
+    {
+        base = strdup(fontPath);
+        char *dot = strrchr(base, '.');
+        if(dot && !strchr(dot, '/'))
+        {
+            *dot = '\0';
+        }
+        prefix = base;
+    }
+
+    // Textures only need to exist as far as the atlas is concerned
+    ftglesBackend_t backend;
+    ftglesRecording_t recording;
+    ftglesInitRecordingBackend(&backend, &recording);
+    ftglesSetBackend(&backend);
+
+    int status = EXIT_SUCCESS;
+    const char *next = sizes;
+
+    while(*next && status == EXIT_SUCCESS)
+    {
+        char *end;
+        unsigned long size = strtoul(next, &end, 10);
+
+        if(end == next || size == 0 || (*end && *end != ','))
+        {
+            fprintf(stderr, "%s: bad size list %s\n", argv[0], sizes);
+            status = EXIT_FAILURE;
+            break;
+        }
+        next = *end ? end + 1 : end;
+
+        FTTextureFont font(fontPath);
+        if(font.Error())
+        {
+            fprintf(stderr, "%s: cannot open %s\n", argv[0], fontPath);
+            status = EXIT_FAILURE;
+            break;
+        }
+
+        font.PageSize(pageSize);
+        font.DistanceField(reference);
+        font.FaceSize(size);
+
+        unsigned int made = charset ? font.Preload(charset)
+                                    : font.Preload(' ', '~');
+
+        char *out = (char *)malloc(strlen(prefix) + 32);
+        sprintf(out, "%s-%lu.ftc", prefix, size);
+
+        if(font.SaveCache(out))
+        {
+            printf("%s: %u glyphs, %u pages\n", out, made, font.PageCount());
+        }
+        else
+        {
+            fprintf(stderr, "%s: cannot write %s\n", argv[0], out);
+            status = EXIT_FAILURE;
+        }
+        free(out);
+    }
+
+    ftglesSetBackend(NULL);
+    free(charset);
+    free(base);
+
+    return status;
+}
+
@@ -0,0 +1,167 @@
+/*
+ 
+ Copyright (c) 2010 David Petrie
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ 
+ */
+
+/*
+ * ftglesblitbench - measures how fast FTBufferGlyph composites glyph
+ * bitmaps into an FTBuffer, the inner loop of FTBufferFont and of any
+ * software text rendering built on FTBuffer.
+ *
+ * The printable ASCII glyphs are rasterised once, then drawn in lines
+ * across a buffer, the last line running off its edges, for the given
+ * number of passes.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "FTGL/ftgles.h"
+
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-s size] [-n passes] [-x width] [-y height] font\n"
+            "\n"
+            "  -s size    point size (default 24)\n"
+            "  -n passes  times to fill the buffer (default 1000)\n"
+            "  -x width   buffer width in pixels (default 1024)\n"
+            "  -y height  buffer height in pixels (default 256)\n",
+            name);
+}
+
+
+static double now()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+
+int main(int argc, char **argv)
+{
+    unsigned long size = 24;
+    unsigned long passes = 1000;
+    int width = 1024;
+    int height = 256;
+    int opt;
+
+    while((opt = getopt(argc, argv, "s:n:x:y:h")) != -1)
+    {
+        switch(opt)
+        {
+            case 's': size = strtoul(optarg, NULL, 10); break;
+            case 'n': passes = strtoul(optarg, NULL, 10); break;
+            case 'x': width = atoi(optarg); break;
+            case 'y': height = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if(optind != argc - 1 || !size || width <= 0 || height <= 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FT_Library library;
+    FT_Face face;
+
+    if(FT_Init_FreeType(&library))
+    {
+        fprintf(stderr, "%s: cannot start FreeType\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if(FT_New_Face(library, argv[optind], 0, &face)
+       || FT_Set_Char_Size(face, 0, size * 64, 72, 72))
+    {
+        fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[optind]);
+        FT_Done_FreeType(library);
+        return EXIT_FAILURE;
+    }
+
+    FTBuffer buffer;
+    buffer.Size(width, height);
+
+    const int first = ' ', last = '~';
+    FTBufferGlyph *glyphs[last - first + 1];
+    unsigned long area = 0;
+
+    for(int c = first; c <= last; c++)
+    {
+        glyphs[c - first] = NULL;
+
+        if(!FT_Load_Char(face, c, FT_LOAD_NO_HINTING | FT_LOAD_NO_BITMAP))
+        {
+            glyphs[c - first] = new FTBufferGlyph(face->glyph, &buffer);
+            area += face->glyph->bitmap.width * face->glyph->bitmap.rows;
+        }
+    }
+
+    // One line every size points, then one half off the bottom left
+    float lineHeight = static_cast<float>(size);
+    unsigned long drawn = 0;
+    double start = now();
+
+    for(unsigned long pass = 0; pass < passes; pass++)
+    {
+        for(float y = lineHeight; y < height + lineHeight; y += lineHeight)
+        {
+            FTPoint pen(y >= height ? -lineHeight : 0.0f, height - y);
+
+            for(int c = first; c <= last && pen.X() < width; c++)
+            {
+                if(glyphs[c - first])
+                {
+                    pen += glyphs[c - first]->Render(pen, FTGL::RENDER_ALL);
+                    drawn++;
+                }
+            }
+        }
+    }
+
+    double seconds = now() - start;
+    double perSecond = seconds > 0.0 ? drawn / seconds : 0.0;
+
+    printf("%lu glyphs in %.3f s: %.0f glyphs/s, %.1f Mpixels/s\n",
+           drawn, seconds, perSecond,
+           perSecond * area / (last - first + 1) / 1e6);
+
+    for(int c = first; c <= last; c++)
+    {
+        delete glyphs[c - first];
+    }
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+
+    return EXIT_SUCCESS;
+}